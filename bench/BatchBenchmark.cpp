@@ -0,0 +1,138 @@
+// Compares one Renderer::draw per quad (the way application.cpp draws) with
+// the BatchRenderer for 1k/10k/100k quads. Runs headless, e.g. on llvmpipe:
+//   LIBGL_ALWAYS_SOFTWARE=1 ./BatchBenchmark [frames]
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include <stdio.h>
+#include <GL/glew.h>
+
+#include "HeadlessContext.h"
+#include "BatchRenderer.h"
+#include "Render.h"
+#include "UniformBuffer.h"
+#include "vendor/glm/glm/glm.hpp"
+#include "vendor/glm/glm/gtc/matrix_transform.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+//the first frames include lazy shader compilation in the driver
+static const int WarmupFrames = 2;
+
+struct FrameResult{
+    unsigned int drawCalls;
+    double cpuMs;       //time spent issuing GL calls
+    double frameMs;     //including glFinish
+};
+
+static double elapsedMs(Clock::time_point start, Clock::time_point end){
+    return std::chrono::duration<double, std::milli>(end-start).count();
+}
+
+static FrameResult runNaive(const std::vector<glm::vec2>& positions, int frames){
+    const float quad[] = {0.f, 0.f,  1.f, 0.f,  1.f, 1.f,  0.f, 1.f};
+    const unsigned int indices[] = {0, 1, 2, 2, 3, 0};
+
+    VertexArray va;
+    VertexBuffer vb(quad, sizeof(quad));
+    VertexBufferLayout layout;
+    layout.push<float>(2);
+    va.addBuffer(vb, layout);
+    IndexBuffer ib(indices, 6);
+
+    Shader shader("res/shaders/Basic.shader");
+    UniformHandle colorUniform = shader.getUniformHandle("u_Color");
+    UniformHandle modelUniform = shader.getUniformHandle("u_Model");
+    Renderer renderer;
+
+    FrameResult result = {0, 0.0, 0.0};
+    for(int frame=-WarmupFrames; frame<frames; frame++){
+        Clock::time_point start = Clock::now();
+        renderer.clear();
+        shader.bind();
+        shader.setUniform4f(colorUniform, 0.f, 1.f, 0.f, 1.f);
+        for(unsigned int i=0; i<positions.size(); i++){
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(positions[i], 0.0f));
+            model = glm::scale(model, glm::vec3(4.0f, 4.0f, 1.0f));
+            shader.setUniformMat4f(modelUniform, model);
+            renderer.draw(va, ib, shader);
+        }
+        Clock::time_point submitted = Clock::now();
+        glFinish();
+        Clock::time_point finished = Clock::now();
+
+        if(frame >= 0){
+            result.cpuMs += elapsedMs(start, submitted);
+            result.frameMs += elapsedMs(start, finished);
+        }
+    }
+    result.drawCalls = positions.size();
+    result.cpuMs /= frames;
+    result.frameMs /= frames;
+    return result;
+}
+
+static FrameResult runBatched(const std::vector<glm::vec2>& positions, int frames){
+    BatchRenderer batch;
+    Renderer renderer;
+    const glm::vec4 color(0.f, 1.f, 0.f, 1.f);
+
+    FrameResult result = {0, 0.0, 0.0};
+    for(int frame=-WarmupFrames; frame<frames; frame++){
+        batch.resetStats();
+        Clock::time_point start = Clock::now();
+        renderer.clear();
+        batch.beginScene();
+        for(unsigned int i=0; i<positions.size(); i++)
+            batch.drawQuad(positions[i], glm::vec2(4.0f), color);
+        batch.endScene();
+        Clock::time_point submitted = Clock::now();
+        glFinish();
+        Clock::time_point finished = Clock::now();
+
+        if(frame >= 0){
+            result.cpuMs += elapsedMs(start, submitted);
+            result.frameMs += elapsedMs(start, finished);
+        }
+    }
+    result.drawCalls = batch.getStats().drawCalls;
+    result.cpuMs /= frames;
+    result.frameMs /= frames;
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 10;
+    if(frames <= 0)
+        frames = 10;
+
+    HeadlessContext context(1000, 1000);
+    if(!context.isValid())
+        return 1;
+    printf("OpenGL-Renderer %s, %d frames per run\n\n", glGetString(GL_RENDERER), frames);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glm::mat4 proj = glm::ortho(0.0f, 1000.0f, 0.0f, 1000.0f, -1.0f, 1.0f);
+    CameraBlock camera = {proj, glm::mat4(1.0f), proj};
+    Std140Buffer cameraData;
+    camera.pack(cameraData);
+    UniformBuffer cameraBuffer(CameraBlock::Size, CameraBinding);
+    cameraBuffer.setData(cameraData);
+
+    printf("%8s  %-8s %12s %14s %16s\n", "quads", "mode", "draw calls", "cpu ms/frame", "frame ms/frame");
+    const unsigned int counts[] = {1000, 10000, 100000};
+    for(unsigned int count : counts){
+        std::vector<glm::vec2> positions(count);
+        srand(1);
+        for(unsigned int i=0; i<count; i++)
+            positions[i] = glm::vec2(rand()%996, rand()%996);
+
+        FrameResult naive = runNaive(positions, frames);
+        printf("%8u  %-8s %12u %14.3f %16.3f\n", count, "naive", naive.drawCalls, naive.cpuMs, naive.frameMs);
+        FrameResult batched = runBatched(positions, frames);
+        printf("%8u  %-8s %12u %14.3f %16.3f\n", count, "batched", batched.drawCalls, batched.cpuMs, batched.frameMs);
+    }
+    return 0;
+}
@@ -0,0 +1,380 @@
+// Runs scripted scenes headless for a fixed number of frames and reports the
+// p50/p99 CPU, GPU and total frame time and the draw calls per frame as JSON,
+// so the results of two commits can be compared. "make bench" runs it.
+//   LIBGL_ALWAYS_SOFTWARE=1 ./FrameBenchmark [--frames N] [--scene name] [--label text] [--output file]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <GL/glew.h>
+
+#include "HeadlessContext.h"
+#include "BatchRenderer.h"
+#include "GLState.h"
+#include "Render.h"
+#include "StreamingBuffer.h"
+#include "UniformBuffer.h"
+#include "texture.h"
+#include "vendor/glm/glm/glm.hpp"
+#include "vendor/glm/glm/gtc/matrix_transform.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+//the Makefile passes the compiler flags, results of different builds don't compare
+#ifndef BUILD_FLAGS
+#define BUILD_FLAGS "unknown"
+#endif
+
+static const int WarmupFrames = 5;
+static const int Width = 1000, Height = 1000;
+
+static const float s_Quad[] = {0.f, 0.f,  1.f, 0.f,  1.f, 1.f,  0.f, 1.f};
+static const unsigned int s_QuadIndices[] = {0, 1, 2, 2, 3, 0};
+
+//one scripted scene, draw() renders a complete frame (the harness clears)
+class Scene{
+public:
+    virtual ~Scene(){}
+    virtual const char* getName() const = 0;
+    virtual void draw(int frame) = 0;
+};
+
+//many small colored quads that move every frame, through the BatchRenderer
+class ManyQuadsScene : public Scene{
+private:
+    static const unsigned int QuadCount = 20000;
+    BatchRenderer m_Batch;
+    std::vector<glm::vec2> m_Positions;
+
+public:
+    ManyQuadsScene() : m_Positions(QuadCount) {
+        srand(1);
+        for(unsigned int i=0; i<QuadCount; i++)
+            m_Positions[i] = glm::vec2(rand()%990, rand()%990);
+    }
+
+    const char* getName() const {return "many-quads";}
+
+    void draw(int frame){
+        float offset = (float)(frame%100)*0.1f;
+        m_Batch.beginScene();
+        for(unsigned int i=0; i<QuadCount; i++){
+            glm::vec4 color((i%7)/7.0f, (i%5)/5.0f, 1.0f, 1.0f);
+            m_Batch.drawQuad(m_Positions[i]+glm::vec2(offset, 0.0f), glm::vec2(6.0f), color);
+        }
+        m_Batch.endScene();
+    }
+};
+
+//quads with more distinct textures than a batch has slots, so batches flush on texture changes
+class ManyTexturesScene : public Scene{
+private:
+    static const unsigned int TextureCount = 64;
+    static const unsigned int QuadCount = 4000;
+    BatchRenderer m_Batch;
+    std::vector<std::unique_ptr<Texture>> m_Textures;
+
+public:
+    ManyTexturesScene(){
+        std::vector<unsigned char> pixels(16*16*4);
+        for(unsigned int t=0; t<TextureCount; t++){
+            for(unsigned int i=0; i<16*16; i++){
+                pixels[i*4+0] = (unsigned char)(t*4);
+                pixels[i*4+1] = (unsigned char)(i);
+                pixels[i*4+2] = (unsigned char)(255-t*4);
+                pixels[i*4+3] = 255;
+            }
+            m_Textures.push_back(std::unique_ptr<Texture>(new Texture(16, 16, &pixels[0])));
+        }
+    }
+
+    const char* getName() const {return "many-textures";}
+
+    void draw(int frame){
+        m_Batch.beginScene();
+        for(unsigned int i=0; i<QuadCount; i++){
+            glm::vec2 position((float)((i*37)%980), (float)((i*53+frame)%980));
+            m_Batch.drawQuad(position, glm::vec2(16.0f), *m_Textures[(i+frame)%TextureCount]);
+        }
+        m_Batch.endScene();
+    }
+};
+
+//every draw uses a different program than the one before
+class ShaderSwitchScene : public Scene{
+private:
+    static const unsigned int ShaderCount = 8;
+    static const unsigned int ObjectCount = 2000;
+    VertexArray m_VertexArray;
+    VertexBuffer m_VertexBuffer;
+    IndexBuffer m_IndexBuffer;
+    std::vector<std::unique_ptr<Shader>> m_Shaders;
+    std::vector<UniformHandle> m_ModelUniforms;
+    Renderer m_Renderer;
+
+public:
+    ShaderSwitchScene()
+        : m_VertexBuffer(s_Quad, sizeof(s_Quad)), m_IndexBuffer(s_QuadIndices, 6)
+    {
+        VertexBufferLayout layout;
+        layout.push<float>(2);
+        m_VertexArray.addBuffer(m_VertexBuffer, layout);
+        for(unsigned int i=0; i<ShaderCount; i++){
+            m_Shaders.push_back(std::unique_ptr<Shader>(new Shader("res/shaders/Basic.shader")));
+            m_Shaders[i]->bind();
+            m_Shaders[i]->setUniform4f("u_Color", i/(float)ShaderCount, 1.f, 0.f, 1.f);
+            m_ModelUniforms.push_back(m_Shaders[i]->getUniformHandle("u_Model"));
+        }
+    }
+
+    const char* getName() const {return "shader-switch";}
+
+    void draw(int frame){
+        for(unsigned int i=0; i<ObjectCount; i++){
+            Shader& shader = *m_Shaders[i%ShaderCount];
+            glm::vec3 position((float)((i*37+frame)%990), (float)((i*53)%990), 0.0f);
+            glm::mat4 model = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(10.0f, 10.0f, 1.0f));
+            shader.bind();
+            shader.setUniformMat4f(m_ModelUniforms[i%ShaderCount], model);
+            m_Renderer.draw(m_VertexArray, m_IndexBuffer, shader);
+        }
+    }
+};
+
+//a grid whose vertices are rewritten every frame through a StreamingBuffer
+class StreamingScene : public Scene{
+private:
+    static const unsigned int GridSize = 128;
+    static const unsigned int QuadCount = GridSize*GridSize;
+    static const unsigned int FrameSize = QuadCount*4*sizeof(glm::vec2);
+    StreamingBuffer m_VertexBuffer;
+    VertexArray m_VertexArray;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+    Shader m_Shader;
+    Renderer m_Renderer;
+
+public:
+    StreamingScene()
+        : m_VertexBuffer(GL_ARRAY_BUFFER, FrameSize, sizeof(glm::vec2)), m_Shader("res/shaders/Basic.shader")
+    {
+        VertexBufferLayout layout;
+        layout.push<float>(2);
+        m_VertexArray.addBuffer(m_VertexBuffer, layout);
+
+        std::vector<unsigned int> indices(QuadCount*6);
+        for(unsigned int i=0; i<QuadCount; i++){
+            for(int j=0; j<6; j++)
+                indices[i*6+j] = i*4+s_QuadIndices[j];
+        }
+        m_IndexBuffer.reset(new IndexBuffer(&indices[0], indices.size()));
+
+        m_Shader.bind();
+        m_Shader.setUniform4f("u_Color", 0.f, 0.5f, 1.f, 1.f);
+        m_Shader.setUniformMat4f("u_Model", glm::mat4(1.0f));
+    }
+
+    const char* getName() const {return "streaming";}
+
+    void draw(int frame){
+        glm::vec2* vertices = (glm::vec2*)m_VertexBuffer.map(FrameSize);
+        const float cell = (float)Width/GridSize;
+        for(unsigned int y=0; y<GridSize; y++){
+            for(unsigned int x=0; x<GridSize; x++){
+                float wave = 2.0f*sinf(x*0.2f + frame*0.1f);
+                glm::vec2 corner(x*cell, y*cell+wave);
+                *vertices++ = corner;
+                *vertices++ = corner+glm::vec2(cell-1.0f, 0.0f);
+                *vertices++ = corner+glm::vec2(cell-1.0f, cell-1.0f);
+                *vertices++ = corner+glm::vec2(0.0f, cell-1.0f);
+            }
+        }
+        unsigned int offset = m_VertexBuffer.commit(FrameSize);
+        m_Renderer.draw(m_VertexArray, *m_IndexBuffer, m_Shader, QuadCount*6, offset/sizeof(glm::vec2));
+    }
+};
+
+static Scene* createScene(const std::string& name){
+    if(name == "many-quads")
+        return new ManyQuadsScene();
+    if(name == "many-textures")
+        return new ManyTexturesScene();
+    if(name == "shader-switch")
+        return new ShaderSwitchScene();
+    if(name == "streaming")
+        return new StreamingScene();
+    return nullptr;
+}
+
+static const char* s_SceneNames[] = {"many-quads", "many-textures", "shader-switch", "streaming"};
+
+struct Percentiles{
+    double p50, p99;
+};
+
+//nearest rank
+static Percentiles getPercentiles(std::vector<double> values){
+    std::sort(values.begin(), values.end());
+    Percentiles result = {0.0, 0.0};
+    if(values.empty())
+        return result;
+    result.p50 = values[(size_t)std::ceil(0.50*values.size())-1];
+    result.p99 = values[(size_t)std::ceil(0.99*values.size())-1];
+    return result;
+}
+
+struct SceneResult{
+    std::string name;
+    Percentiles cpuMs;      //issuing the frame's GL calls
+    Percentiles gpuMs;      //GL_TIME_ELAPSED around the frame
+    Percentiles frameMs;    //including glFinish
+    unsigned int drawCalls; //per frame, the maximum over all frames
+};
+
+static SceneResult run(Scene& scene, int frames){
+    Renderer renderer;
+    std::vector<unsigned int> queries(frames);
+    glGenQueries(frames, &queries[0]);
+    std::vector<double> cpuMs(frames), frameMs(frames), gpuMs(frames);
+
+    SceneResult result;
+    result.name = scene.getName();
+    result.drawCalls = 0;
+    for(int frame=-WarmupFrames; frame<frames; frame++){
+        Renderer::resetStats();
+        Clock::time_point start = Clock::now();
+        if(frame >= 0)
+            glBeginQuery(GL_TIME_ELAPSED, queries[frame]);
+        renderer.clear();
+        scene.draw(frame);
+        if(frame >= 0)
+            glEndQuery(GL_TIME_ELAPSED);
+        Clock::time_point submitted = Clock::now();
+        glFinish();
+        Clock::time_point finished = Clock::now();
+
+        if(frame >= 0){
+            cpuMs[frame] = std::chrono::duration<double, std::milli>(submitted-start).count();
+            frameMs[frame] = std::chrono::duration<double, std::milli>(finished-start).count();
+            result.drawCalls = std::max(result.drawCalls, Renderer::getStats().drawCalls);
+        }
+    }
+
+    //all queries are read after the run, so the results don't stall a frame
+    for(int frame=0; frame<frames; frame++){
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(queries[frame], GL_QUERY_RESULT, &elapsed);
+        gpuMs[frame] = elapsed/1000000.0;
+    }
+    glDeleteQueries(frames, &queries[0]);
+
+    result.cpuMs = getPercentiles(cpuMs);
+    result.gpuMs = getPercentiles(gpuMs);
+    result.frameMs = getPercentiles(frameMs);
+    return result;
+}
+
+static std::string escapeJson(const std::string& text){
+    std::string escaped;
+    for(unsigned int i=0; i<text.size(); i++){
+        char c = text[i];
+        if(c == '"' || c == '\\')
+            escaped += '\\';
+        if((unsigned char)c >= 0x20)
+            escaped += c;
+    }
+    return escaped;
+}
+
+static void writeJson(FILE* file, const std::string& label, int frames, const std::vector<SceneResult>& results){
+    fprintf(file, "{\n");
+    fprintf(file, "  \"label\": \"%s\",\n", escapeJson(label).c_str());
+    fprintf(file, "  \"build_flags\": \"%s\",\n", escapeJson(BUILD_FLAGS).c_str());
+    fprintf(file, "  \"renderer\": \"%s\",\n", escapeJson((const char*)glGetString(GL_RENDERER)).c_str());
+    fprintf(file, "  \"width\": %d,\n  \"height\": %d,\n  \"frames\": %d,\n", Width, Height, frames);
+    fprintf(file, "  \"scenes\": [\n");
+    for(unsigned int i=0; i<results.size(); i++){
+        const SceneResult& r = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"draw_calls\": %u,\n", r.name.c_str(), r.drawCalls);
+        fprintf(file, "     \"cpu_ms\": {\"p50\": %.4f, \"p99\": %.4f},\n", r.cpuMs.p50, r.cpuMs.p99);
+        fprintf(file, "     \"gpu_ms\": {\"p50\": %.4f, \"p99\": %.4f},\n", r.gpuMs.p50, r.gpuMs.p99);
+        fprintf(file, "     \"frame_ms\": {\"p50\": %.4f, \"p99\": %.4f}}%s\n", r.frameMs.p50, r.frameMs.p99,
+            i+1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = 200;
+    std::string sceneName, label, output;
+    for(int i=1; i<argc; i++){
+        bool hasValue = i+1 < argc;
+        if(strcmp(argv[i], "--frames") == 0 && hasValue)
+            frames = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--scene") == 0 && hasValue)
+            sceneName = argv[++i];
+        else if(strcmp(argv[i], "--label") == 0 && hasValue)
+            label = argv[++i];
+        else if(strcmp(argv[i], "--output") == 0 && hasValue)
+            output = argv[++i];
+        else{
+            fprintf(stderr, "Usage: %s [--frames N] [--scene name] [--label text] [--output file]\n", argv[0]);
+            return 1;
+        }
+    }
+    if(frames <= 0)
+        frames = 200;
+
+    //no window, so nothing waits for vsync
+    HeadlessContext context(Width, Height);
+    if(!context.isValid())
+        return 1;
+
+    GLState::setBlend(true);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glm::mat4 proj = glm::ortho(0.0f, (float)Width, 0.0f, (float)Height, -1.0f, 1.0f);
+    CameraBlock camera = {proj, glm::mat4(1.0f), proj};
+    Std140Buffer cameraData;
+    camera.pack(cameraData);
+    UniformBuffer cameraBuffer(CameraBlock::Size, CameraBinding);
+    cameraBuffer.setData(cameraData);
+
+    std::vector<SceneResult> results;
+    for(const char* name : s_SceneNames){
+        if(!sceneName.empty() && sceneName != name)
+            continue;
+        std::unique_ptr<Scene> scene(createScene(name));
+        results.push_back(run(*scene, frames));
+    }
+    if(results.empty()){
+        fprintf(stderr, "Unknown scene '%s'\n", sceneName.c_str());
+        return 1;
+    }
+
+    if(output.empty()){
+        writeJson(stdout, label, frames, results);
+        return 0;
+    }
+
+    FILE* file = fopen(output.c_str(), "w");
+    if(!file){
+        fprintf(stderr, "Can't write '%s'\n", output.c_str());
+        return 1;
+    }
+    writeJson(file, label, frames, results);
+    fclose(file);
+
+    printf("%-14s %12s %18s %18s %18s\n", "scene", "draw calls", "cpu ms p50/p99", "gpu ms p50/p99", "frame ms p50/p99");
+    for(unsigned int i=0; i<results.size(); i++){
+        const SceneResult& r = results[i];
+        printf("%-14s %12u %8.3f/%-9.3f %8.3f/%-9.3f %8.3f/%-9.3f\n", r.name.c_str(), r.drawCalls,
+            r.cpuMs.p50, r.cpuMs.p99, r.gpuMs.p50, r.gpuMs.p99, r.frameMs.p50, r.frameMs.p99);
+    }
+    printf("\nwrote %s\n", output.c_str());
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Decode time of large JPEGs with JpegDecoder on 2/4/8 threads against
+// stb_image on one thread. The images have to match byte for byte.
+//   ./JpegDecodeBenchmark [iterations] [files...]
+// Without files all JPEGs in res/textures are used. Only baseline JPEGs with
+// restart markers at row starts can be split, e.g. libjpeg's -restart 1.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <dirent.h>
+
+#include "stb_image.h"
+#include "MappedFile.h"
+#include "JpegDecoder.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* TextureDirectory = "res/textures";
+static const unsigned int ThreadCounts[] = {2, 4, 8};
+
+static double elapsedMs(Clock::time_point start, Clock::time_point end){
+    return std::chrono::duration<double, std::milli>(end-start).count();
+}
+
+static bool hasExtension(const std::string& name, const char* extension){
+    size_t length = strlen(extension);
+    return name.size() > length && name.compare(name.size()-length, length, extension) == 0;
+}
+
+static std::vector<std::string> findJpegs(const char* directory){
+    std::vector<std::string> paths;
+    DIR* dir = opendir(directory);
+    if(!dir)
+        return paths;
+    while(dirent* entry = readdir(dir)){
+        std::string name = entry->d_name;
+        if(hasExtension(name, ".jpg") || hasExtension(name, ".jpeg"))
+            paths.push_back(std::string(directory) + "/" + name);
+    }
+    closedir(dir);
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 10;
+    if(iterations < 1)
+        iterations = 1;
+
+    std::vector<std::string> paths;
+    for(int i=2; i<argc; i++)
+        paths.push_back(argv[i]);
+    if(paths.empty())
+        paths = findJpegs(TextureDirectory);
+    if(paths.empty()){
+        fprintf(stderr, "No JPEG files found\n");
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<JpegDecoder>> decoders;
+    for(unsigned int i=0; i<sizeof(ThreadCounts)/sizeof(ThreadCounts[0]); i++)
+        decoders.push_back(std::unique_ptr<JpegDecoder>(new JpegDecoder(ThreadCounts[i]-1)));
+
+    printf("best of %d decodes, %u hardware threads\n\n", iterations, std::thread::hardware_concurrency());
+    printf("%-32s %11s %10s", "file", "size", "1 thread");
+    for(unsigned int i=0; i<decoders.size(); i++)
+        printf(" %7u thr %7s", decoders[i]->getThreadCount(), "speedup");
+    printf("  output\n");
+
+    bool allIdentical = true;
+    for(unsigned int p=0; p<paths.size(); p++){
+        MappedFile file(paths[p]);
+        if(!file.isOpen()){
+            fprintf(stderr, "Failed to open '%s'\n", paths[p].c_str());
+            allIdentical = false;
+            continue;
+        }
+
+        //reference, flipped like textures are
+        int width = 0, height = 0, bpp = 0;
+        unsigned char* reference = nullptr;
+        double singleMs = 1e30;
+        for(int i=0; i<=iterations; i++){
+            stbi_image_free(reference);
+            stbi_set_flip_vertically_on_load_thread(1);
+            Clock::time_point start = Clock::now();
+            reference = stbi_load_from_memory(file.getData(), (int)file.getSize(), &width, &height, &bpp, 4);
+            if(i > 0)
+                singleMs = std::min(singleMs, elapsedMs(start, Clock::now()));
+        }
+        if(!reference){
+            fprintf(stderr, "Failed to decode '%s': %s\n", paths[p].c_str(), stbi_failure_reason());
+            allIdentical = false;
+            continue;
+        }
+
+        char size[32];
+        snprintf(size, sizeof(size), "%dx%d", width, height);
+        printf("%-32s %11s %10.3f", paths[p].c_str(), size, singleMs);
+
+        const char* output = "identical";
+        for(unsigned int d=0; d<decoders.size(); d++){
+            double parallelMs = 1e30;
+            bool split = true;
+            for(int i=0; i<=iterations && split; i++){
+                int w = 0, h = 0, n = 0;
+                Clock::time_point start = Clock::now();
+                unsigned char* pixels = decoders[d]->decode(file.getData(), file.getSize(), w, h, n, true);
+                Clock::time_point end = Clock::now();
+                split = pixels != nullptr;
+                if(!split)
+                    break;
+                if(w != width || h != height || n != bpp || memcmp(pixels, reference, (size_t)width*height*4) != 0){
+                    output = "MISMATCH";
+                    allIdentical = false;
+                }
+                stbi_image_free(pixels);
+                if(i > 0)
+                    parallelMs = std::min(parallelMs, elapsedMs(start, end));
+            }
+            if(split)
+                printf(" %11.3f %6.2fx", parallelMs, singleMs/parallelMs);
+            else{
+                printf(" %11s %7s", "-", "-");
+                output = "not split";
+            }
+        }
+        printf("  %s\n", output);
+        stbi_image_free(reference);
+    }
+    return allIdentical ? 0 : 1;
+}
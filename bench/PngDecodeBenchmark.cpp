@@ -0,0 +1,122 @@
+// Decode throughput of the patched stb_image PNG path against the upstream
+// code (STBI_NO_FAST_PNG). Every image is decoded with its own channel count
+// and as RGBA, and both results must match byte for byte.
+//   ./PngDecodeBenchmark [iterations] [files...]
+// Without files all PNGs in res/textures are used.
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <dirent.h>
+
+#include "stb_image.h"
+#include "MappedFile.h"
+#include "StbImageStock.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* TextureDirectory = "res/textures";
+
+static double elapsedMs(Clock::time_point start, Clock::time_point end){
+    return std::chrono::duration<double, std::milli>(end-start).count();
+}
+
+static std::vector<std::string> findPngs(const char* directory){
+    std::vector<std::string> paths;
+    DIR* dir = opendir(directory);
+    if(!dir)
+        return paths;
+    while(dirent* entry = readdir(dir)){
+        std::string name = entry->d_name;
+        if(name.size() > 4 && name.compare(name.size()-4, 4, ".png") == 0)
+            paths.push_back(std::string(directory) + "/" + name);
+    }
+    closedir(dir);
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+struct DecodeResult{
+    double stockMs;
+    double fastMs;
+    bool identical;
+};
+
+//best of iterations, the first decode of each variant warms the caches
+static DecodeResult decode(const MappedFile& file, int desiredChannels, int iterations, size_t& bytes){
+    DecodeResult result = {1e30, 1e30, true};
+    for(int i=0; i<=iterations; i++){
+        int w0, h0, n0, w1, h1, n1;
+        Clock::time_point start = Clock::now();
+        unsigned char* stock = stockLoadFromMemory(file.getData(), (int)file.getSize(), &w0, &h0, &n0, desiredChannels);
+        Clock::time_point middle = Clock::now();
+        unsigned char* fast = stbi_load_from_memory(file.getData(), (int)file.getSize(), &w1, &h1, &n1, desiredChannels);
+        Clock::time_point end = Clock::now();
+
+        if(!stock || !fast || w0 != w1 || h0 != h1 || n0 != n1){
+            result.identical = false;
+        }
+        else{
+            bytes = (size_t)w0*h0*(desiredChannels ? desiredChannels : n0);
+            if(memcmp(stock, fast, bytes) != 0)
+                result.identical = false;
+        }
+        stockImageFree(stock);
+        stbi_image_free(fast);
+
+        if(i > 0){
+            result.stockMs = std::min(result.stockMs, elapsedMs(start, middle));
+            result.fastMs = std::min(result.fastMs, elapsedMs(middle, end));
+        }
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if(iterations < 1)
+        iterations = 1;
+
+    std::vector<std::string> paths;
+    for(int i=2; i<argc; i++)
+        paths.push_back(argv[i]);
+    if(paths.empty())
+        paths = findPngs(TextureDirectory);
+    if(paths.empty()){
+        fprintf(stderr, "No PNG files found\n");
+        return 1;
+    }
+
+    printf("best of %d decodes\n\n", iterations);
+    printf("%-32s %8s %10s %10s %10s %10s %8s  %s\n", "file", "channels", "stock ms", "fast ms", "stock MB/s", "fast MB/s", "speedup", "output");
+
+    bool allIdentical = true;
+    double stockTotal = 0.0, fastTotal = 0.0;
+    for(unsigned int i=0; i<paths.size(); i++){
+        MappedFile file(paths[i]);
+        if(!file.isOpen()){
+            fprintf(stderr, "Failed to open '%s'\n", paths[i].c_str());
+            allIdentical = false;
+            continue;
+        }
+        const int channels[2] = {0, 4};
+        for(int c=0; c<2; c++){
+            size_t bytes = 0;
+            DecodeResult result = decode(file, channels[c], iterations, bytes);
+            allIdentical = allIdentical && result.identical;
+            stockTotal += result.stockMs;
+            fastTotal += result.fastMs;
+
+            double megabytes = bytes / (1024.0*1024.0);
+            printf("%-32s %8s %10.3f %10.3f %10.1f %10.1f %7.2fx  %s\n", paths[i].c_str(), channels[c] ? "rgba" : "native",
+                result.stockMs, result.fastMs, megabytes / (result.stockMs/1000.0), megabytes / (result.fastMs/1000.0),
+                result.stockMs / result.fastMs, result.identical ? "identical" : "MISMATCH");
+        }
+    }
+    printf("\ntotal: stock %.3f ms, fast %.3f ms, %.2fx\n", stockTotal, fastTotal, stockTotal / fastTotal);
+    return allIdentical ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+// Draws a scene with many materials in random order: directly with the
+// GLState cache disabled and enabled, and through the sorted render queue.
+// Reports how many state calls reach the driver per frame.
+//   LIBGL_ALWAYS_SOFTWARE=1 ./StateCacheBenchmark [frames]
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+#include <stdio.h>
+#include <GL/glew.h>
+
+#include "HeadlessContext.h"
+#include "GLState.h"
+#include "Render.h"
+#include "UniformBuffer.h"
+#include "texture.h"
+#include "vendor/glm/glm/glm.hpp"
+#include "vendor/glm/glm/gtc/matrix_transform.hpp"
+
+typedef std::chrono::steady_clock Clock;
+
+static const int WarmupFrames = 2;
+static const unsigned int ObjectCount = 10000;
+
+enum class Mode{
+    Uncached, Cached, Queued
+};
+
+struct Object{
+    glm::mat4 model;
+    unsigned int shader;
+    unsigned int texture;
+};
+
+struct FrameResult{
+    GLState::Stats stats;
+    double cpuMs;
+};
+
+static FrameResult run(Mode mode, const std::vector<Object>& objects, int frames){
+    const float quad[] = {0.f, 0.f,  1.f, 0.f,  1.f, 1.f,  0.f, 1.f};
+    const unsigned int indices[] = {0, 1, 2, 2, 3, 0};
+
+    VertexArray va;
+    VertexBuffer vb(quad, sizeof(quad));
+    VertexBufferLayout layout;
+    layout.push<float>(2);
+    va.addBuffer(vb, layout);
+    IndexBuffer ib(indices, 6);
+
+    Shader shaderA("res/shaders/Basic.shader");
+    Shader shaderB("res/shaders/Basic.shader");
+    Shader* shaders[2] = {&shaderA, &shaderB};
+    UniformHandle modelUniforms[2];
+    for(int i=0; i<2; i++){
+        shaders[i]->bind();
+        shaders[i]->setUniform4f("u_Color", 0.f, 1.f, 0.f, 1.f);
+        modelUniforms[i] = shaders[i]->getUniformHandle("u_Model");
+    }
+    Texture doge("res/textures/doge.png");
+    Texture logo("res/textures/ifs-logo.png");
+    const Texture* textures[2] = {&doge, &logo};
+    Renderer renderer;
+
+    GLState::setCaching(mode != Mode::Uncached);
+    FrameResult result = {{0, 0}, 0.0};
+    for(int frame=-WarmupFrames; frame<frames; frame++){
+        GLState::resetStats();
+        Clock::time_point start = Clock::now();
+        renderer.clear();
+        for(unsigned int i=0; i<objects.size(); i++){
+            const Object& object = objects[i];
+            Shader& shader = *shaders[object.shader];
+            if(mode == Mode::Queued){
+                renderer.submit(va, ib, shader, textures[object.texture], object.model);
+            }
+            else{
+                textures[object.texture]->bind(0);
+                shader.bind();
+                shader.setUniformMat4f(modelUniforms[object.shader], object.model);
+                renderer.draw(va, ib, shader);
+            }
+        }
+        if(mode == Mode::Queued)
+            renderer.flush();
+        Clock::time_point submitted = Clock::now();
+        glFinish();
+
+        if(frame >= 0){
+            result.cpuMs += std::chrono::duration<double, std::milli>(submitted-start).count();
+            result.stats = GLState::getStats();
+        }
+    }
+    result.cpuMs /= frames;
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 10;
+    if(frames <= 0)
+        frames = 10;
+
+    HeadlessContext context(1000, 1000);
+    if(!context.isValid())
+        return 1;
+    printf("OpenGL-Renderer %s, %u objects, %d frames per run\n\n", glGetString(GL_RENDERER), ObjectCount, frames);
+
+    glm::mat4 proj = glm::ortho(0.0f, 1000.0f, 0.0f, 1000.0f, -1.0f, 1.0f);
+    CameraBlock camera = {proj, glm::mat4(1.0f), proj};
+    Std140Buffer cameraData;
+    camera.pack(cameraData);
+    UniformBuffer cameraBuffer(CameraBlock::Size, CameraBinding);
+    cameraBuffer.setData(cameraData);
+    std::vector<Object> objects(ObjectCount);
+    srand(1);
+    for(unsigned int i=0; i<ObjectCount; i++){
+        glm::vec3 position(rand()%996, rand()%996, 0.0f);
+        objects[i].model = glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(4.0f, 4.0f, 1.0f));
+        objects[i].shader = rand()%2;
+        objects[i].texture = rand()%2;
+    }
+
+    printf("%-14s %14s %14s %14s\n", "mode", "issued/frame", "skipped/frame", "cpu ms/frame");
+    const Mode modes[] = {Mode::Uncached, Mode::Cached, Mode::Queued};
+    const char* names[] = {"direct", "state cache", "sorted queue"};
+    for(int i=0; i<3; i++){
+        FrameResult result = run(modes[i], objects, frames);
+        printf("%-14s %14u %14u %14.3f\n", names[i], result.stats.issued, result.stats.skipped, result.cpuMs);
+    }
+    return 0;
+}
@@ -0,0 +1,19 @@
+//A second, private copy of stb_image without the local PNG fast paths.
+//STB_IMAGE_STATIC keeps its symbols from clashing with src/stb_image.cpp.
+#define STB_IMAGE_STATIC
+#define STBI_NO_FAST_PNG
+#define STB_IMAGE_IMPLEMENTATION
+#ifdef __GNUC__
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#include "stb_image.h"
+
+#include "StbImageStock.h"
+
+unsigned char* stockLoadFromMemory(const unsigned char* buffer, int length, int* width, int* height, int* channels, int desiredChannels){
+    return stbi_load_from_memory(buffer, length, width, height, channels, desiredChannels);
+}
+
+void stockImageFree(void* pixels){
+    stbi_image_free(pixels);
+}
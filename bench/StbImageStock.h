@@ -0,0 +1,6 @@
+#pragma once
+
+//stb_image built with STBI_NO_FAST_PNG, i.e. the upstream decoder, as the
+//reference for PngDecodeBenchmark. Results are freed with stockImageFree().
+unsigned char* stockLoadFromMemory(const unsigned char* buffer, int length, int* width, int* height, int* channels, int desiredChannels);
+void stockImageFree(void* pixels);
@@ -3,11 +3,17 @@
 
 layout (location=0) in vec2 positions;
 
-uniform mat4 u_MVP; 
+layout (std140) uniform Camera
+{
+    mat4 u_ViewProj;
+    mat4 u_View;
+    mat4 u_Proj;
+};
+uniform mat4 u_Model;
 
 void main()
 {
-    gl_Position = u_MVP * vec4(positions.x, positions.y, 1.0, 1.0);
+    gl_Position = u_ViewProj * u_Model * vec4(positions.x, positions.y, 1.0, 1.0);
 };
 
 
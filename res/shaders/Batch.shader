@@ -0,0 +1,68 @@
+#shader vertex
+#version 330 core
+
+layout (location=0) in vec2 a_Position;
+layout (location=1) in vec4 a_Color;
+layout (location=2) in vec2 a_TexCoord;
+layout (location=3) in float a_TexIndex;
+
+layout (std140) uniform Camera
+{
+    mat4 u_ViewProj;
+    mat4 u_View;
+    mat4 u_Proj;
+};
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+flat out int v_TexIndex;
+
+void main()
+{
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+    v_TexIndex = int(a_TexIndex);
+    gl_Position = u_ViewProj * vec4(a_Position, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in int v_TexIndex;
+
+out vec4 color;
+uniform sampler2D u_Textures[15];
+uniform sampler2DArray u_TextureArray;
+
+void main()
+{
+    //indices past the texture slots are layers of the texture array
+    if(v_TexIndex >= 15){
+        color = texture(u_TextureArray, vec3(v_TexCoord, float(v_TexIndex-15))) * v_Color;
+        return;
+    }
+
+    //GLSL 3.30 only allows constant indices into sampler arrays
+    vec4 texColor;
+    switch(v_TexIndex){
+        case  0: texColor = texture(u_Textures[ 0], v_TexCoord); break;
+        case  1: texColor = texture(u_Textures[ 1], v_TexCoord); break;
+        case  2: texColor = texture(u_Textures[ 2], v_TexCoord); break;
+        case  3: texColor = texture(u_Textures[ 3], v_TexCoord); break;
+        case  4: texColor = texture(u_Textures[ 4], v_TexCoord); break;
+        case  5: texColor = texture(u_Textures[ 5], v_TexCoord); break;
+        case  6: texColor = texture(u_Textures[ 6], v_TexCoord); break;
+        case  7: texColor = texture(u_Textures[ 7], v_TexCoord); break;
+        case  8: texColor = texture(u_Textures[ 8], v_TexCoord); break;
+        case  9: texColor = texture(u_Textures[ 9], v_TexCoord); break;
+        case 10: texColor = texture(u_Textures[10], v_TexCoord); break;
+        case 11: texColor = texture(u_Textures[11], v_TexCoord); break;
+        case 12: texColor = texture(u_Textures[12], v_TexCoord); break;
+        case 13: texColor = texture(u_Textures[13], v_TexCoord); break;
+        case 14: texColor = texture(u_Textures[14], v_TexCoord); break;
+    }
+    color = texColor * v_Color;
+};
@@ -0,0 +1,59 @@
+#shader vertex
+#version 330 core
+
+layout (location=0) in vec2 a_Position;
+layout (location=1) in vec4 a_Color;
+layout (location=2) in vec2 a_TexCoord;
+layout (location=3) in float a_TexIndex;
+
+layout (std140) uniform Camera
+{
+    mat4 u_ViewProj;
+    mat4 u_View;
+    mat4 u_Proj;
+};
+
+out vec4 v_Color;
+out vec2 v_TexCoord;
+flat out int v_TexIndex;
+
+void main()
+{
+    v_Color = a_Color;
+    v_TexCoord = a_TexCoord;
+    v_TexIndex = int(a_TexIndex);
+    gl_Position = u_ViewProj * vec4(a_Position, 0.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+#extension GL_ARB_bindless_texture : require
+//the handle isn't dynamically uniform, it changes per quad within a draw
+#extension GL_NV_gpu_shader5 : require
+
+in vec4 v_Color;
+in vec2 v_TexCoord;
+flat in int v_TexIndex;
+
+out vec4 color;
+
+//two 64 bit handles per uvec4, the array has a 16 byte stride in std140
+layout (std140) uniform TextureHandles
+{
+    uvec4 u_Handles[128];
+};
+uniform sampler2DArray u_TextureArray;
+
+void main()
+{
+    //indices past the handles are layers of the texture array
+    if(v_TexIndex >= 256){
+        color = texture(u_TextureArray, vec3(v_TexCoord, float(v_TexIndex-256))) * v_Color;
+        return;
+    }
+
+    uvec4 pair = u_Handles[v_TexIndex >> 1];
+    uvec2 handle = (v_TexIndex & 1) == 0 ? pair.xy : pair.zw;
+    color = texture(sampler2D(handle), v_TexCoord) * v_Color;
+};
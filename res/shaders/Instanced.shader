@@ -0,0 +1,29 @@
+#shader vertex
+#version 330 core
+
+layout (location=0) in vec2 positions;
+layout (location=1) in mat4 a_Model;    //per instance, locations 1-4
+
+layout (std140) uniform Camera
+{
+    mat4 u_ViewProj;
+    mat4 u_View;
+    mat4 u_Proj;
+};
+
+void main()
+{
+    gl_Position = u_ViewProj * a_Model * vec4(positions.x, positions.y, 1.0, 1.0);
+};
+
+
+#shader fragment
+#version 330 core
+
+out vec4 color;
+uniform vec4 u_Color;
+
+void main()
+{
+    color = u_Color;
+};
@@ -0,0 +1,212 @@
+#include "AssetPack.h"
+
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+
+#include "stb_image.h"
+#include "Lz4.h"
+#include "JpegDecoder.h"
+
+static std::vector<std::unique_ptr<AssetPack>> s_Mounted;
+
+AssetPack::AssetPack()
+    : m_Entries(nullptr), m_EntryCount(0), m_Names(nullptr), m_ModifiedTime(0)
+{
+}
+
+bool AssetPack::open(const std::string& path){
+    close();
+    if(!m_File.open(path))
+        return false;
+    struct stat info;
+    m_ModifiedTime = stat(path.c_str(), &info) == 0 ? (int64_t)info.st_mtime : 0;
+
+    const unsigned char* data = m_File.getData();
+    const uint64_t size = m_File.getSize();
+    PackHeader header;
+    if(size < sizeof(header)){
+        close();
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if(memcmp(header.magic, PackMagic, sizeof(PackMagic)) != 0 || header.version != PackVersion
+        || header.indexOffset % alignof(PackEntry) != 0 || header.indexOffset > size
+        || header.entryCount > (size-header.indexOffset)/sizeof(PackEntry) || header.namesOffset > size)
+    {
+        std::cout << "Invalid asset pack " << path << std::endl;
+        close();
+        return false;
+    }
+
+    m_Entries = (const PackEntry*)(data + header.indexOffset);
+    m_EntryCount = header.entryCount;
+    m_Names = (const char*)(data + header.namesOffset);
+
+    //validate once so lookups can trust the index
+    for(unsigned int i=0; i<m_EntryCount; i++){
+        const PackEntry& entry = m_Entries[i];
+        if(entry.offset > size || entry.storedSize > size-entry.offset
+            || header.namesOffset + entry.nameOffset + entry.nameLength > size
+            || (entry.compression == None && entry.storedSize != entry.size) || entry.compression > LZ4)
+        {
+            std::cout << "Corrupt entry in asset pack " << path << std::endl;
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetPack::close(){
+    m_File.close();
+    m_Entries = nullptr;
+    m_EntryCount = 0;
+    m_Names = nullptr;
+}
+
+const PackEntry* AssetPack::find(const std::string& name) const{
+    const std::string normalized = normalizeName(name);
+    const uint64_t hash = hashName(normalized);
+
+    unsigned int first = 0;
+    unsigned int count = m_EntryCount;
+    while(count > 0){
+        unsigned int half = count/2;
+        if(m_Entries[first+half].nameHash < hash){
+            first += half+1;
+            count -= half+1;
+        }
+        else
+            count = half;
+    }
+    //hash collisions are resolved by comparing the names
+    for(unsigned int i=first; i<m_EntryCount && m_Entries[i].nameHash == hash; i++){
+        const PackEntry& entry = m_Entries[i];
+        if(entry.nameLength == normalized.size() && memcmp(m_Names + entry.nameOffset, normalized.data(), entry.nameLength) == 0)
+            return &entry;
+    }
+    return nullptr;
+}
+
+std::string AssetPack::getName(const PackEntry& entry) const{
+    return std::string(m_Names + entry.nameOffset, entry.nameLength);
+}
+
+std::string AssetPack::normalizeName(const std::string& name){
+    std::string normalized = name;
+    for(unsigned int i=0; i<normalized.size(); i++){
+        if(normalized[i] == '\\')
+            normalized[i] = '/';
+    }
+    while(normalized.compare(0, 2, "./") == 0)
+        normalized.erase(0, 2);
+    return normalized;
+}
+
+uint64_t AssetPack::hashName(const std::string& name){
+    const std::string normalized = normalizeName(name);
+    uint64_t hash = 14695981039346656037ull;
+    for(unsigned int i=0; i<normalized.size(); i++){
+        hash ^= (unsigned char)normalized[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool AssetPack::mount(const std::string& path){
+    std::unique_ptr<AssetPack> pack(new AssetPack());
+    if(!pack->open(path))
+        return false;
+    s_Mounted.push_back(std::move(pack));
+    return true;
+}
+
+void AssetPack::unmountAll(){
+    s_Mounted.clear();
+}
+
+const AssetPack* AssetPack::findMounted(const std::string& name, const PackEntry*& entry){
+    for(unsigned int i=s_Mounted.size(); i-- > 0;){
+        entry = s_Mounted[i]->find(name);
+        if(entry)
+            return s_Mounted[i].get();
+    }
+    entry = nullptr;
+    return nullptr;
+}
+
+AssetFile::AssetFile()
+    : m_Data(nullptr), m_Size(0)
+{
+}
+
+AssetFile::AssetFile(const std::string& path)
+    : AssetFile()
+{
+    open(path);
+}
+
+bool AssetFile::open(const std::string& path){
+    close();
+
+    const PackEntry* entry;
+    const AssetPack* pack = AssetPack::findMounted(path, entry);
+    //one stat per packed asset, still much cheaper than opening every file
+    struct stat info;
+    if(pack && stat(path.c_str(), &info) == 0 && (int64_t)info.st_mtime > pack->getModifiedTime())
+        pack = nullptr;
+    if(!pack){
+        if(!m_File.open(path))
+            return false;
+        m_Data = m_File.getData();
+        m_Size = m_File.getSize();
+        return true;
+    }
+
+    if(entry->size == 0)
+        return false;
+    const unsigned char* stored = pack->getStoredData(*entry);
+    if(entry->compression == AssetPack::None){
+        m_Data = stored;
+        m_Size = entry->size;
+        return true;
+    }
+
+    m_Buffer.resize(entry->size);
+    if(!lz4Decompress(stored, entry->storedSize, &m_Buffer[0], m_Buffer.size())){
+        std::cout << "Corrupt data for " << path << " in asset pack" << std::endl;
+        close();
+        return false;
+    }
+    m_Data = &m_Buffer[0];
+    m_Size = m_Buffer.size();
+    return true;
+}
+
+void AssetFile::close(){
+    m_File.close();
+    std::vector<unsigned char>().swap(m_Buffer);
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+unsigned char* loadImage(const std::string& path, int& width, int& height, int& bpp, bool flipVertically){
+    AssetFile file(path);
+    if(!file.isOpen()){
+        //e.g. missing or empty files, stdio reads them and sets stbi_failure_reason()
+        stbi_set_flip_vertically_on_load_thread(flipVertically);
+        return stbi_load(path.c_str(), &width, &height, &bpp, 4);
+    }
+    return decodeImage(file.getData(), file.getSize(), width, height, bpp, flipVertically);
+}
+
+unsigned char* decodeImage(const unsigned char* data, size_t size, int& width, int& height, int& bpp, bool flipVertically){
+    unsigned char* pixels = JpegDecoder::getShared().decode(data, size, width, height, bpp, flipVertically);
+    if(pixels)
+        return pixels;
+
+    //thread local, so loader threads don't race with each other
+    stbi_set_flip_vertically_on_load_thread(flipVertically);
+    return stbi_load_from_memory(data, (int)size, &width, &height, &bpp, 4);
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+
+//Pack file layout, all offsets are from the start of the file:
+//  header | file data, each aligned | index sorted by name hash | names
+struct PackHeader{
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint64_t indexOffset;
+    uint64_t namesOffset;
+};
+
+struct PackEntry{
+    uint64_t nameHash;
+    uint64_t offset;
+    uint64_t storedSize;        //bytes in the pack
+    uint64_t size;              //bytes after decompression
+    uint32_t compression;
+    uint32_t nameOffset;        //from namesOffset, names aren't terminated
+    uint32_t nameLength;
+    uint32_t reserved;
+};
+
+static const char PackMagic[4] = {'A', 'P', 'A', 'K'};
+static const uint32_t PackVersion = 1;
+
+//Many small assets in one memory mapped file written by tools/AssetPacker.
+//Lookups are a binary search over the index, uncompressed files are read
+//straight from the mapping and LZ4 files are decompressed on read.
+class AssetPack{
+public:
+    enum Compression{
+        None = 0,
+        LZ4
+    };
+
+private:
+    MappedFile m_File;
+    const PackEntry* m_Entries;
+    unsigned int m_EntryCount;
+    const char* m_Names;
+    int64_t m_ModifiedTime;     //of the pack file, loose files that are newer win
+
+public:
+    AssetPack();
+
+    //false if the file can't be mapped or isn't a valid pack
+    bool open(const std::string& path);
+    void close();
+
+    inline bool isOpen() const {return m_File.isOpen();}
+    inline unsigned int getEntryCount() const {return m_EntryCount;}
+    inline int64_t getModifiedTime() const {return m_ModifiedTime;}
+
+    const PackEntry* find(const std::string& name) const;
+    //returns the stored bytes of an entry, they are compressed unless its compression is None
+    inline const unsigned char* getStoredData(const PackEntry& entry) const {return m_File.getData() + entry.offset;}
+    std::string getName(const PackEntry& entry) const;
+
+    //FNV-1a of the name with '\\' as '/' and without a leading "./"
+    static uint64_t hashName(const std::string& name);
+    static std::string normalizeName(const std::string& name);
+
+    //mounted packs are searched by AssetFile before the file system, packs
+    //mounted later win. A loose file that was modified after the pack was
+    //written wins over its entry, so edits show up without "make pack".
+    //Not thread-safe, mount before loading starts.
+    static bool mount(const std::string& path);
+    static void unmountAll();
+    static const AssetPack* findMounted(const std::string& name, const PackEntry*& entry);
+};
+
+//Read-only bytes of an asset, from a mounted pack if it contains the path and
+//the loose file isn't newer, otherwise from a memory mapping of the loose file.
+class AssetFile{
+private:
+    MappedFile m_File;
+    std::vector<unsigned char> m_Buffer;    //decompressed pack entries
+    const unsigned char* m_Data;
+    size_t m_Size;
+
+public:
+    AssetFile();
+    explicit AssetFile(const std::string& path);
+
+    AssetFile(const AssetFile&) = delete;
+    AssetFile& operator=(const AssetFile&) = delete;
+
+    //false if the asset doesn't exist or is empty
+    bool open(const std::string& path);
+    void close();
+
+    inline bool isOpen() const {return m_Data != nullptr;}
+    inline const unsigned char* getData() const {return m_Data;}
+    inline size_t getSize() const {return m_Size;}
+};
+
+//Decodes an image asset to RGBA8 with stb_image straight from the pack or a
+//mapping of the file, large JPEGs with restart markers on several threads.
+//Images are flipped for GL by default. Sets stb_image's flip flag of the
+//calling thread, free the result with stbi_image_free().
+unsigned char* loadImage(const std::string& path, int& width, int& height, int& bpp, bool flipVertically=true);
+//same for an image file that is already in memory
+unsigned char* decodeImage(const unsigned char* data, size_t size, int& width, int& height, int& bpp, bool flipVertically=true);
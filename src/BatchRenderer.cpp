@@ -0,0 +1,269 @@
+#include "BatchRenderer.h"
+
+static std::vector<unsigned int> generateQuadIndices(unsigned int maxQuads){
+    std::vector<unsigned int> indices(maxQuads*6);
+    for(unsigned int i=0; i<maxQuads; i++){
+        unsigned int offset = i*4;
+        indices[i*6+0] = offset+0;
+        indices[i*6+1] = offset+1;
+        indices[i*6+2] = offset+2;
+        indices[i*6+3] = offset+2;
+        indices[i*6+4] = offset+3;
+        indices[i*6+5] = offset+0;
+    }
+    return indices;
+}
+
+//full batches that fit into one segment of the streaming buffer, so several
+//flushes per frame don't wait for the GPU to finish the previous ones
+static const unsigned int BatchesPerSegment = 4;
+
+static const unsigned char s_WhitePixel[4] = {255, 255, 255, 255};
+
+static const glm::vec4 s_UnitQuad[4] = {
+    {-0.5f, -0.5f, 0.0f, 1.0f},
+    { 0.5f, -0.5f, 0.0f, 1.0f},
+    { 0.5f,  0.5f, 0.0f, 1.0f},
+    {-0.5f,  0.5f, 0.0f, 1.0f}
+};
+
+static const glm::vec2 s_TexCoords[4] = {
+    {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}
+};
+
+BatchRenderer::BatchRenderer(unsigned int maxQuads, bool allowBindless)
+    : m_MaxQuads(maxQuads),
+      m_Bindless(allowBindless && GLEW_ARB_bindless_texture && GLEW_NV_gpu_shader5),
+      m_MaxTextures(m_Bindless ? MaxBindlessTextures : MaxTextureSlots),
+      m_ArrayUnit(m_Bindless ? 0 : MaxTextureSlots),
+      m_VertexBuffer(GL_ARRAY_BUFFER, BatchesPerSegment*maxQuads*4*sizeof(QuadVertex), sizeof(QuadVertex)),
+      m_IndexBuffer(&generateQuadIndices(maxQuads)[0], maxQuads*6),
+      m_Shader(m_Bindless ? "res/shaders/BatchBindless.shader" : "res/shaders/Batch.shader"),
+      m_WhiteTexture(1, 1, s_WhitePixel),
+      m_VertexBase(nullptr), m_VertexPtr(nullptr), m_QuadCount(0),
+      m_TextureSlots(m_MaxTextures), m_TextureSlotCount(1), m_TextureArray(nullptr)
+{
+    VertexBufferLayout layout;
+    layout.push<float>(2);  //position
+    layout.push<float>(4);  //color
+    layout.push<float>(2);  //texCoord
+    layout.push<float>(1);  //texIndex
+    m_VertexArray.addBuffer(m_VertexBuffer, layout);
+
+    //slot 0 is always the white texture for untextured quads
+    m_TextureSlots[0] = &m_WhiteTexture;
+
+    m_Shader.bind();
+    if(m_Bindless){
+        m_HandleBuffer.reset(new UniformBuffer(m_MaxTextures*sizeof(uint64_t), TextureHandlesBinding));
+    }
+    else{
+        int samplers[MaxTextureSlots];
+        for(unsigned int i=0; i<MaxTextureSlots; i++)
+            samplers[i] = i;
+        m_Shader.setUniform1iv("u_Textures", MaxTextureSlots, samplers);
+    }
+    m_Shader.setUniform1i("u_TextureArray", m_ArrayUnit);
+    m_Shader.unbind();
+
+    m_VertexArray.unbind();
+    m_VertexBuffer.unbind();
+    m_IndexBuffer.unbind();
+
+    resetStats();
+}
+
+BatchRenderer::~BatchRenderer(){
+}
+
+void BatchRenderer::beginScene(){
+    m_TextureSlotCount = 1;
+    m_TextureArray = nullptr;
+}
+
+void BatchRenderer::endScene(){
+    flush();
+}
+
+void BatchRenderer::flush(){
+    if(!m_VertexBase)
+        return;
+
+    unsigned int offset = m_VertexBuffer.commit(m_QuadCount*4*sizeof(QuadVertex));
+    m_VertexBase = nullptr;
+    m_VertexPtr = nullptr;
+    if(m_QuadCount == 0)
+        return;
+
+    if(m_Bindless){
+        //a handle is a uvec2, so two of them fill one uvec4 of u_Handles
+        m_HandleBlock.clear();
+        for(unsigned int i=0; i<m_TextureSlotCount; i++){
+            uint64_t handle = m_TextureSlots[i]->getBindlessHandle();
+            m_HandleBlock.push(glm::uvec2((uint32_t)handle, (uint32_t)(handle >> 32)));
+        }
+        m_HandleBuffer->setData(m_HandleBlock);
+        m_HandleBuffer->bind();
+    }
+    else{
+        for(unsigned int i=0; i<m_TextureSlotCount; i++){
+            m_TextureSlots[i]->bind(i);
+            m_Sampler.bind(i);
+        }
+    }
+    if(m_TextureArray){
+        m_TextureArray->bind(m_ArrayUnit);
+        m_Sampler.bind(m_ArrayUnit);
+    }
+
+    m_Renderer.draw(m_VertexArray, m_IndexBuffer, m_Shader, m_QuadCount*6, offset/sizeof(QuadVertex));
+
+    m_Stats.drawCalls++;
+    m_Stats.quadCount += m_QuadCount;
+
+    m_QuadCount = 0;
+    m_TextureSlotCount = 1;
+    m_TextureArray = nullptr;
+}
+
+float BatchRenderer::getTextureIndex(const Texture& texture){
+    for(unsigned int i=1; i<m_TextureSlotCount; i++){
+        if(m_TextureSlots[i] == &texture)
+            return (float)i;
+    }
+
+    if(m_TextureSlotCount == m_MaxTextures)
+        flush();
+
+    m_TextureSlots[m_TextureSlotCount] = &texture;
+    return (float)m_TextureSlotCount++;
+}
+
+float BatchRenderer::getTextureIndex(const TextureArray& array, int layer){
+    if(m_TextureArray && m_TextureArray != &array)
+        flush();
+
+    m_TextureArray = &array;
+    return (float)(m_MaxTextures+layer);
+}
+
+//called first by every drawQuad, so a full batch is flushed before a texture
+//slot is picked and the slot stays registered in the batch the quad ends up in
+void BatchRenderer::reserveQuad(){
+    if(m_QuadCount == m_MaxQuads)
+        flush();
+}
+
+void BatchRenderer::pushQuad(const glm::vec2 corners[4], const glm::vec4& color, float texIndex, const glm::vec2 texCoords[4]){
+    if(!m_VertexBase){
+        m_VertexBase = (QuadVertex*)m_VertexBuffer.map(m_MaxQuads*4*sizeof(QuadVertex));
+        m_VertexPtr = m_VertexBase;
+    }
+
+    for(int i=0; i<4; i++){
+        m_VertexPtr->position = corners[i];
+        m_VertexPtr->color = color;
+        m_VertexPtr->texCoord = texCoords[i];
+        m_VertexPtr->texIndex = texIndex;
+        m_VertexPtr++;
+    }
+    m_QuadCount++;
+}
+
+void BatchRenderer::drawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color){
+    reserveQuad();
+    const glm::vec2 corners[4] = {
+        position,
+        {position.x+size.x, position.y},
+        position+size,
+        {position.x, position.y+size.y}
+    };
+    pushQuad(corners, color, 0.0f, s_TexCoords);
+}
+
+void BatchRenderer::drawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint){
+    reserveQuad();
+    float texIndex = getTextureIndex(texture);
+    const glm::vec2 corners[4] = {
+        position,
+        {position.x+size.x, position.y},
+        position+size,
+        {position.x, position.y+size.y}
+    };
+    pushQuad(corners, tint, texIndex, s_TexCoords);
+}
+
+void BatchRenderer::drawQuad(const glm::mat4& transform, const glm::vec4& color){
+    reserveQuad();
+    glm::vec2 corners[4];
+    for(int i=0; i<4; i++)
+        corners[i] = glm::vec2(transform*s_UnitQuad[i]);
+    pushQuad(corners, color, 0.0f, s_TexCoords);
+}
+
+void BatchRenderer::drawQuad(const glm::mat4& transform, const Texture& texture, const glm::vec4& tint){
+    reserveQuad();
+    float texIndex = getTextureIndex(texture);
+    glm::vec2 corners[4];
+    for(int i=0; i<4; i++)
+        corners[i] = glm::vec2(transform*s_UnitQuad[i]);
+    pushQuad(corners, tint, texIndex, s_TexCoords);
+}
+
+static void getRegionTexCoords(const AtlasRegion& region, glm::vec2 texCoords[4]){
+    texCoords[0] = region.uvMin;
+    texCoords[1] = glm::vec2(region.uvMax.x, region.uvMin.y);
+    texCoords[2] = region.uvMax;
+    texCoords[3] = glm::vec2(region.uvMin.x, region.uvMax.y);
+}
+
+void BatchRenderer::drawQuad(const glm::vec2& position, const glm::vec2& size, const AtlasRegion& region, const glm::vec4& tint){
+    reserveQuad();
+    float texIndex = getTextureIndex(*region.texture);
+    const glm::vec2 corners[4] = {
+        position,
+        {position.x+size.x, position.y},
+        position+size,
+        {position.x, position.y+size.y}
+    };
+    glm::vec2 texCoords[4];
+    getRegionTexCoords(region, texCoords);
+    pushQuad(corners, tint, texIndex, texCoords);
+}
+
+void BatchRenderer::drawQuad(const glm::mat4& transform, const AtlasRegion& region, const glm::vec4& tint){
+    reserveQuad();
+    float texIndex = getTextureIndex(*region.texture);
+    glm::vec2 corners[4];
+    for(int i=0; i<4; i++)
+        corners[i] = glm::vec2(transform*s_UnitQuad[i]);
+    glm::vec2 texCoords[4];
+    getRegionTexCoords(region, texCoords);
+    pushQuad(corners, tint, texIndex, texCoords);
+}
+
+void BatchRenderer::drawQuad(const glm::vec2& position, const glm::vec2& size, const TextureArray& array, int layer, const glm::vec4& tint){
+    reserveQuad();
+    float texIndex = getTextureIndex(array, layer);
+    const glm::vec2 corners[4] = {
+        position,
+        {position.x+size.x, position.y},
+        position+size,
+        {position.x, position.y+size.y}
+    };
+    pushQuad(corners, tint, texIndex, s_TexCoords);
+}
+
+void BatchRenderer::drawQuad(const glm::mat4& transform, const TextureArray& array, int layer, const glm::vec4& tint){
+    reserveQuad();
+    float texIndex = getTextureIndex(array, layer);
+    glm::vec2 corners[4];
+    for(int i=0; i<4; i++)
+        corners[i] = glm::vec2(transform*s_UnitQuad[i]);
+    pushQuad(corners, tint, texIndex, s_TexCoords);
+}
+
+void BatchRenderer::resetStats(){
+    m_Stats.drawCalls = 0;
+    m_Stats.quadCount = 0;
+}
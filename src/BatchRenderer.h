@@ -0,0 +1,101 @@
+#pragma once
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+#include "Render.h"
+#include "texture.h"
+#include "Sampler.h"
+#include "TextureAtlas.h"
+#include "TextureArray.h"
+#include "UniformBuffer.h"
+#include "vendor/glm/glm/glm.hpp"
+
+//one vertex of a batched quad, position is already transformed on the CPU
+struct QuadVertex{
+    glm::vec2 position;
+    glm::vec4 color;
+    glm::vec2 texCoord;
+    float texIndex;
+};
+
+//Collects quads into one streaming vertex buffer and draws them with as few
+//draw calls as possible. A batch is flushed when it is full, when all texture
+//slots are used, when a different texture array is used or at endScene().
+//With ARB_bindless_texture the textures of a batch are passed as handles in a
+//uniform block instead of texture units, so a batch holds many more of them.
+//The handle differs per quad, which ARB_bindless_texture only allows with
+//NV_gpu_shader5, so bindless needs both extensions.
+class BatchRenderer{
+public:
+    struct Stats{
+        unsigned int drawCalls;
+        unsigned int quadCount;
+    };
+
+    static const unsigned int MaxTextureSlots = 15;         //the 16th unit holds the texture array
+    static const unsigned int MaxBindlessTextures = 256;
+
+private:
+    unsigned int m_MaxQuads;
+    bool m_Bindless;
+    unsigned int m_MaxTextures;         //per batch, texture indices above are array layers
+    unsigned int m_ArrayUnit;
+
+    VertexArray m_VertexArray;
+    StreamingBuffer m_VertexBuffer;
+    IndexBuffer m_IndexBuffer;
+    Shader m_Shader;
+    Texture m_WhiteTexture;
+    Sampler m_Sampler;          //shared by all texture slots, bindless textures use their own parameters
+    std::unique_ptr<UniformBuffer> m_HandleBuffer;
+    Renderer m_Renderer;
+
+    //vertices are written straight into the mapped streaming buffer
+    QuadVertex* m_VertexBase;
+    QuadVertex* m_VertexPtr;
+    unsigned int m_QuadCount;
+    std::vector<const Texture*> m_TextureSlots;
+    Std140Buffer m_HandleBlock;
+    unsigned int m_TextureSlotCount;
+    const TextureArray* m_TextureArray;
+
+    Stats m_Stats;
+
+    void reserveQuad();
+    float getTextureIndex(const Texture& texture);
+    float getTextureIndex(const TextureArray& array, int layer);
+    void pushQuad(const glm::vec2 corners[4], const glm::vec4& color, float texIndex, const glm::vec2 texCoords[4]);
+
+public:
+    BatchRenderer(unsigned int maxQuads=10000, bool allowBindless=true);
+    ~BatchRenderer();
+
+    //the camera comes from the shared Camera uniform block
+    void beginScene();
+    void endScene();
+    void flush();
+
+    //axis aligned quads, position is the lower left corner
+    void drawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color);
+    void drawQuad(const glm::vec2& position, const glm::vec2& size, const Texture& texture, const glm::vec4& tint=glm::vec4(1.0f));
+
+    //unit quad centered at the origin transformed by transform
+    void drawQuad(const glm::mat4& transform, const glm::vec4& color);
+    void drawQuad(const glm::mat4& transform, const Texture& texture, const glm::vec4& tint=glm::vec4(1.0f));
+
+    //atlas regions, all regions of a page share one texture slot
+    void drawQuad(const glm::vec2& position, const glm::vec2& size, const AtlasRegion& region, const glm::vec4& tint=glm::vec4(1.0f));
+    void drawQuad(const glm::mat4& transform, const AtlasRegion& region, const glm::vec4& tint=glm::vec4(1.0f));
+
+    //layers of a texture array, one array per batch
+    void drawQuad(const glm::vec2& position, const glm::vec2& size, const TextureArray& array, int layer, const glm::vec4& tint=glm::vec4(1.0f));
+    void drawQuad(const glm::mat4& transform, const TextureArray& array, int layer, const glm::vec4& tint=glm::vec4(1.0f));
+
+    //trilinear by default, e.g. add anisotropy or change the wrap mode here
+    inline Sampler& getSampler() {return m_Sampler;}
+    inline bool isBindless() const {return m_Bindless;}
+
+    inline const Stats& getStats() const {return m_Stats;}
+    void resetStats();
+};
@@ -0,0 +1,44 @@
+#include "FrameBuffer.h"
+#include "GLState.h"
+
+FrameBuffer::FrameBuffer(int width, int height)
+    : m_RendererID(0), m_DepthBuffer(0), m_ColorTexture(width, height, nullptr), m_Width(width), m_Height(height)
+{
+    glGenRenderbuffers(1, &m_DepthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_DepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+    glGenFramebuffers(1, &m_RendererID);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorTexture.getRendererID(), 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthBuffer);
+    GLState::viewport(0, 0, width, height);
+};
+
+FrameBuffer::~FrameBuffer(){
+    glDeleteFramebuffers(1, &m_RendererID);
+    glDeleteRenderbuffers(1, &m_DepthBuffer);
+};
+
+void FrameBuffer::resize(int width, int height){
+    m_Width = width;
+    m_Height = height;
+    m_ColorTexture.resize(width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_DepthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    bind();
+};
+
+bool FrameBuffer::isComplete() const{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+};
+
+void FrameBuffer::bind() const{
+    glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+    GLState::viewport(0, 0, m_Width, m_Height);
+};
+
+void FrameBuffer::unbind() const{
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+};
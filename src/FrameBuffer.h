@@ -0,0 +1,30 @@
+#pragma once
+
+#include "texture.h"
+
+//Offscreen render target with an RGBA8 color texture and a depth/stencil
+//renderbuffer. bind() also sets the viewport to the full target.
+class FrameBuffer{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_DepthBuffer;
+    Texture m_ColorTexture;
+    int m_Width, m_Height;
+
+public:
+    FrameBuffer(int width, int height);
+    ~FrameBuffer();
+
+    //reallocates both attachments, the contents are undefined afterwards
+    void resize(int width, int height);
+    bool isComplete() const;
+
+    void bind() const;
+    //binds the default framebuffer again, the caller sets its viewport
+    void unbind() const;
+
+    inline const Texture& getColorTexture() const {return m_ColorTexture;}
+    inline int getWidth() const {return m_Width;}
+    inline int getHeight() const {return m_Height;}
+    inline unsigned int getRendererID() const {return m_RendererID;}
+};
@@ -0,0 +1,84 @@
+#include "FrameReader.h"
+#include "GLState.h"
+
+FrameReader::FrameReader(int width, int height, const Callback& callback, unsigned int bufferCount)
+    : m_Slots(bufferCount > 0 ? bufferCount : 1), m_Next(0), m_Pending(0), m_Width(width), m_Height(height), m_Callback(callback)
+{
+    for(unsigned int i=0; i<m_Slots.size(); i++){
+        Slot& slot = m_Slots[i];
+        glGenBuffers(1, &slot.rendererID);
+        GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, slot.rendererID);
+        glBufferData(GL_PIXEL_PACK_BUFFER, getFrameSize(), nullptr, GL_STREAM_READ);
+        slot.fence = nullptr;
+        slot.frame = 0;
+    }
+    GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+FrameReader::~FrameReader(){
+    for(unsigned int i=0; i<m_Slots.size(); i++){
+        if(m_Slots[i].fence)
+            glDeleteSync(m_Slots[i].fence);
+        GLState::bufferDeleted(m_Slots[i].rendererID);
+        glDeleteBuffers(1, &m_Slots[i].rendererID);
+    }
+}
+
+void FrameReader::read(unsigned int frame){
+    poll();
+    if(m_Pending == m_Slots.size())
+        complete();
+
+    Slot& slot = m_Slots[m_Next];
+    slot.frame = frame;
+    GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, slot.rendererID);
+    glReadPixels(0, 0, m_Width, m_Height, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+    GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();  //submits the copy so poll() sees it finish
+
+    m_Next = (m_Next+1) % m_Slots.size();
+    m_Pending++;
+}
+
+void FrameReader::complete(){
+    unsigned int count = m_Slots.size();
+    Slot& slot = m_Slots[(m_Next+count-m_Pending) % count];
+
+    //the first wait flushes so the fence is guaranteed to signal
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while(glClientWaitSync(slot.fence, flags, 1000000000) == GL_TIMEOUT_EXPIRED)
+        flags = 0;
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, slot.rendererID);
+    const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, getFrameSize(), GL_MAP_READ_BIT);
+    //a failed map leaves nothing to unmap, the frame is dropped
+    if(pixels){
+        m_Callback(slot.frame, (const unsigned char*)pixels);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    GLState::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_Pending--;
+}
+
+unsigned int FrameReader::poll(){
+    unsigned int completed = 0;
+    unsigned int count = m_Slots.size();
+    while(m_Pending > 0){
+        Slot& slot = m_Slots[(m_Next+count-m_Pending) % count];
+        GLenum status = glClientWaitSync(slot.fence, 0, 0);
+        if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            break;
+        complete();
+        completed++;
+    }
+    return completed;
+}
+
+void FrameReader::finish(){
+    while(m_Pending > 0)
+        complete();
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <GL/glew.h>
+
+//Asynchronous readback of the bound read framebuffer. read() copies the frame
+//into one of a ring of pixel pack buffers and fences the copy, so it returns
+//without waiting for the GPU. A frame is mapped once its fence has passed,
+//usually a few frames later, and only a full ring makes read() wait.
+class FrameReader{
+public:
+    //GL thread, BGRA pixels with the bottom row first, valid during the call
+    typedef std::function<void(unsigned int frame, const unsigned char* pixels)> Callback;
+
+private:
+    struct Slot{
+        unsigned int rendererID;
+        GLsync fence;
+        unsigned int frame;
+    };
+
+    std::vector<Slot> m_Slots;
+    unsigned int m_Next;            //slot the next read goes into
+    unsigned int m_Pending;         //queued reads, the oldest is m_Pending slots before m_Next
+    int m_Width, m_Height;
+    Callback m_Callback;
+
+    //waits for the oldest read and hands it to the callback
+    void complete();
+    //bytes of one frame, wider than int so large sizes don't overflow
+    inline GLsizeiptr getFrameSize() const {return (GLsizeiptr)m_Width*m_Height*4;}
+
+public:
+    FrameReader(int width, int height, const Callback& callback, unsigned int bufferCount=3);
+    ~FrameReader();
+
+    //queues a read of the whole width x height area of the bound read framebuffer
+    void read(unsigned int frame);
+    //hands over the finished reads without waiting, returns how many
+    unsigned int poll();
+    //waits for all queued reads
+    void finish();
+
+    inline unsigned int getPendingCount() const {return m_Pending;}
+};
@@ -0,0 +1,257 @@
+#include "GLDebug.h"
+
+#ifndef NDEBUG
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <signal.h>
+
+struct Message{
+    unsigned int source, type, id, severity;
+    uint64_t hash;
+    char text[GLDebug::MaxMessageLength];
+};
+
+//bounded multi-producer ring, a slot's sequence says whose turn it is
+struct MessageSlot{
+    std::atomic<uint32_t> sequence;
+    Message message;
+};
+
+//hashes of all messages seen so far, a hash is never removed
+struct SeenEntry{
+    std::atomic<uint64_t> hash;     //0 = free
+    std::atomic<uint32_t> repeats;  //since the last poll
+};
+
+static const unsigned int SeenSize = 1024;
+static const unsigned int MaxProbes = 16;
+
+static MessageSlot s_Slots[GLDebug::RingSize];
+static std::atomic<uint32_t> s_Tail(0);
+static uint32_t s_Head = 0;         //GL thread only
+
+static SeenEntry s_Seen[SeenSize];
+static std::atomic<bool> s_RepeatsPending(false);
+
+static std::atomic<unsigned int> s_Received(0), s_Repeats(0), s_Dropped(0);
+static unsigned int s_DroppedReported = 0;  //GL thread only
+static std::atomic<bool> s_BreakOnError(false);
+static bool s_Enabled = false;
+
+//first line of every message, for the repeat counts (GL thread only)
+static std::unordered_map<uint64_t, std::string> s_Texts;
+
+static uint64_t hashMessage(unsigned int source, unsigned int type, unsigned int id, unsigned int severity, const char* text, unsigned int length){
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned int header[4] = {source, type, id, severity};
+    const unsigned char* bytes = (const unsigned char*)header;
+    for(unsigned int i=0; i<sizeof(header); i++)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    for(unsigned int i=0; i<length; i++)
+        hash = (hash ^ (unsigned char)text[i]) * 1099511628211ull;
+    return hash ? hash : 1;
+}
+
+//true if the hash was seen before, a full table just stops de-duplicating
+static bool markSeen(uint64_t hash){
+    for(unsigned int probe=0; probe<MaxProbes; probe++){
+        SeenEntry& entry = s_Seen[(hash+probe) % SeenSize];
+        uint64_t current = entry.hash.load(std::memory_order_acquire);
+        if(current == 0){
+            if(entry.hash.compare_exchange_strong(current, hash, std::memory_order_acq_rel))
+                return false;
+        }
+        if(current == hash){
+            entry.repeats.fetch_add(1, std::memory_order_relaxed);
+            s_RepeatsPending.store(true, std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool push(const Message& message){
+    uint32_t position = s_Tail.load(std::memory_order_relaxed);
+    MessageSlot* slot;
+    while(true){
+        slot = &s_Slots[position % GLDebug::RingSize];
+        uint32_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int32_t difference = (int32_t)(sequence-position);
+        if(difference == 0){
+            if(s_Tail.compare_exchange_weak(position, position+1, std::memory_order_relaxed))
+                break;
+        }
+        else if(difference < 0)
+            return false;
+        else
+            position = s_Tail.load(std::memory_order_relaxed);
+    }
+    slot->message = message;
+    slot->sequence.store(position+1, std::memory_order_release);
+    return true;
+}
+
+static bool pop(Message& message){
+    MessageSlot& slot = s_Slots[s_Head % GLDebug::RingSize];
+    uint32_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if((int32_t)(sequence-(s_Head+1)) < 0)
+        return false;
+    message = slot.message;
+    slot.sequence.store(s_Head+GLDebug::RingSize, std::memory_order_release);
+    s_Head++;
+    return true;
+}
+
+static void APIENTRY debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+    GLsizei length, const GLchar* text, const void* userParam)
+{
+    unsigned int size = length >= 0 ? (unsigned int)length : (unsigned int)strlen(text);
+    s_Received.fetch_add(1, std::memory_order_relaxed);
+
+    if(type == GL_DEBUG_TYPE_ERROR && s_BreakOnError.load(std::memory_order_relaxed))
+        raise(SIGTRAP);
+
+    uint64_t hash = hashMessage(source, type, id, severity, text, size);
+    if(markSeen(hash)){
+        s_Repeats.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Message message;
+    message.source = source;
+    message.type = type;
+    message.id = id;
+    message.severity = severity;
+    message.hash = hash;
+    size = size < GLDebug::MaxMessageLength-1 ? size : GLDebug::MaxMessageLength-1;
+    memcpy(message.text, text, size);
+    message.text[size] = '\0';
+    if(!push(message))
+        s_Dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+static const char* getSourceName(unsigned int source){
+    switch(source){
+    case GL_DEBUG_SOURCE_API:               return "API";
+    case GL_DEBUG_SOURCE_WINDOW_SYSTEM:     return "WINDOW SYSTEM";
+    case GL_DEBUG_SOURCE_SHADER_COMPILER:   return "SHADER COMPILER";
+    case GL_DEBUG_SOURCE_THIRD_PARTY:       return "THIRD PARTY";
+    case GL_DEBUG_SOURCE_APPLICATION:       return "APPLICATION";
+    default:                                return "UNKNOWN";
+    }
+}
+
+static const char* getTypeName(unsigned int type){
+    switch(type){
+    case GL_DEBUG_TYPE_ERROR:               return "ERROR";
+    case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "DEPRECATED BEHAVIOR";
+    case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  return "UNDEFINED BEHAVIOR";
+    case GL_DEBUG_TYPE_PORTABILITY:         return "PORTABILITY";
+    case GL_DEBUG_TYPE_PERFORMANCE:         return "PERFORMANCE";
+    case GL_DEBUG_TYPE_MARKER:              return "MARKER";
+    default:                                return "OTHER";
+    }
+}
+
+static const char* getSeverityName(unsigned int severity){
+    switch(severity){
+    case GL_DEBUG_SEVERITY_HIGH:            return "HIGH";
+    case GL_DEBUG_SEVERITY_MEDIUM:          return "MEDIUM";
+    case GL_DEBUG_SEVERITY_LOW:             return "LOW";
+    default:                                return "NOTIFICATION";
+    }
+}
+
+bool GLDebug::enable(const Settings& settings){
+    if(!GLEW_KHR_debug)
+        return false;
+    if(!s_Enabled){
+        for(unsigned int i=0; i<RingSize; i++)
+            s_Slots[i].sequence.store(i, std::memory_order_relaxed);
+        s_Tail.store(0, std::memory_order_relaxed);
+        s_Head = 0;
+    }
+    s_BreakOnError.store(settings.breakOnError, std::memory_order_relaxed);
+
+    //only the wanted severities reach the callback at all
+    const unsigned int severities[] = {
+        GL_DEBUG_SEVERITY_HIGH, GL_DEBUG_SEVERITY_MEDIUM, GL_DEBUG_SEVERITY_LOW, GL_DEBUG_SEVERITY_NOTIFICATION
+    };
+    bool wanted = true;
+    for(unsigned int severity : severities){
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, severity, 0, nullptr, wanted ? GL_TRUE : GL_FALSE);
+        if(severity == settings.minSeverity)
+            wanted = false;
+    }
+
+    glDebugMessageCallback(debugCallback, nullptr);
+    glEnable(GL_DEBUG_OUTPUT);
+    if(settings.synchronous)
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    else
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    s_Enabled = true;
+    return true;
+}
+
+void GLDebug::disable(){
+    if(!s_Enabled)
+        return;
+    glDisable(GL_DEBUG_OUTPUT);
+    glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageCallback(nullptr, nullptr);
+    poll();
+    s_Enabled = false;
+}
+
+void GLDebug::ignore(unsigned int source, unsigned int type, unsigned int id){
+    if(s_Enabled)
+        glDebugMessageControl(source, type, GL_DONT_CARE, 1, &id, GL_FALSE);
+}
+
+unsigned int GLDebug::poll(){
+    if(!s_Enabled)
+        return 0;
+
+    unsigned int count = 0;
+    Message message;
+    while(pop(message)){
+        std::cout << "OpenGL " << getTypeName(message.type) << " [" << message.id << "] of "
+            << getSeverityName(message.severity) << " severity from " << getSourceName(message.source)
+            << ": " << message.text << std::endl;
+        const char* end = strchr(message.text, '\n');
+        s_Texts[message.hash] = end ? std::string(message.text, end-message.text) : std::string(message.text);
+        count++;
+    }
+
+    if(s_RepeatsPending.exchange(false, std::memory_order_acquire)){
+        for(unsigned int i=0; i<SeenSize; i++){
+            uint32_t repeats = s_Seen[i].repeats.exchange(0, std::memory_order_relaxed);
+            if(repeats == 0)
+                continue;
+            std::unordered_map<uint64_t, std::string>::const_iterator text = s_Texts.find(s_Seen[i].hash.load(std::memory_order_relaxed));
+            std::cout << "OpenGL message repeated " << repeats << " more times: "
+                << (text != s_Texts.end() ? text->second : "(dropped)") << std::endl;
+        }
+    }
+
+    unsigned int dropped = s_Dropped.load(std::memory_order_relaxed);
+    if(dropped != s_DroppedReported){
+        std::cout << "OpenGL debug ring full, " << dropped-s_DroppedReported << " messages dropped" << std::endl;
+        s_DroppedReported = dropped;
+    }
+    return count;
+}
+
+GLDebug::Stats GLDebug::getStats(){
+    Stats stats;
+    stats.received = s_Received.load(std::memory_order_relaxed);
+    stats.repeats = s_Repeats.load(std::memory_order_relaxed);
+    stats.dropped = s_Dropped.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#include <GL/glew.h>
+
+//GL debug output, registered once after the context is created. The driver
+//filters by severity (glDebugMessageControl), so filtered messages never
+//reach the callback. The callback may run on a driver thread: it only copies
+//the message into a lock-free ring, repeats of a message it has seen before
+//are counted instead. poll() prints the new messages and the repeat counts
+//on the GL thread. Output is asynchronous unless synchronous is set, so the
+//driver keeps its fast path. Builds with NDEBUG compile all of it away.
+class GLDebug{
+public:
+    static const unsigned int RingSize = 256;           //messages between two polls
+    static const unsigned int MaxMessageLength = 512;
+
+    struct Settings{
+        unsigned int minSeverity;   //GL_DEBUG_SEVERITY_*, notifications are only shown if this is NOTIFICATION
+        bool synchronous;           //messages come from the call that caused them, slower
+        bool breakOnError;          //SIGTRAP on GL_DEBUG_TYPE_ERROR, needs synchronous to be useful
+
+        Settings() : minSeverity(GL_DEBUG_SEVERITY_LOW), synchronous(false), breakOnError(false) {}
+    };
+
+    struct Stats{
+        unsigned int received;      //passed the driver's filter
+        unsigned int repeats;       //seen before, only counted
+        unsigned int dropped;       //the ring was full
+    };
+
+#ifndef NDEBUG
+    //false if the context has no KHR_debug
+    static bool enable(const Settings& settings=Settings());
+    static void disable();
+    //mutes one message, e.g. a driver's buffer placement notes
+    static void ignore(unsigned int source, unsigned int type, unsigned int id);
+
+    //GL thread, prints what arrived since the last call, returns the number of new messages
+    static unsigned int poll();
+    static Stats getStats();
+#else
+    static inline bool enable(const Settings& =Settings()) {return false;}
+    static inline void disable() {}
+    static inline void ignore(unsigned int, unsigned int, unsigned int) {}
+    static inline unsigned int poll() {return 0;}
+    static inline Stats getStats() {Stats stats = {0, 0, 0}; return stats;}
+#endif
+};
@@ -0,0 +1,270 @@
+#include "GLState.h"
+
+#include <unordered_map>
+#include <GL/glew.h>
+
+static const unsigned int Unknown = 0xFFFFFFFF;
+static const unsigned int MaxTextureUnits = 32;
+static const unsigned int MaxUniformBindings = 16;
+
+//targets with a cached binding, everything else is passed through
+static const unsigned int s_BufferTargets[] = {
+    GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER,
+    GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_TEXTURE_BUFFER
+};
+static const unsigned int BufferTargetCount = sizeof(s_BufferTargets)/sizeof(s_BufferTargets[0]);
+
+static const unsigned int s_TextureTargets[] = {
+    GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_CUBE_MAP
+};
+static const unsigned int TextureTargetCount = sizeof(s_TextureTargets)/sizeof(s_TextureTargets[0]);
+
+static bool s_Caching = true;
+static GLState::Stats s_Stats = {0, 0};
+
+static unsigned int s_Program = Unknown;
+static unsigned int s_VertexArray = Unknown;
+static unsigned int s_Buffers[BufferTargetCount];
+static std::unordered_map<unsigned int, unsigned int> s_ElementBuffers;  //element buffer binding is VAO state
+static unsigned int s_UniformBindings[MaxUniformBindings];
+static unsigned int s_ActiveUnit = Unknown;
+static unsigned int s_Textures[MaxTextureUnits][TextureTargetCount];
+static unsigned int s_Samplers[MaxTextureUnits];
+static unsigned int s_Blend = Unknown;
+static unsigned int s_BlendSrc = Unknown, s_BlendDst = Unknown;
+static int s_Viewport[4];
+static bool s_ViewportValid = false;
+
+static bool s_Initialized = false;
+
+static void initialize(){
+    if(s_Initialized)
+        return;
+    GLState::invalidate();
+    s_Initialized = true;
+}
+
+static int findIndex(const unsigned int* targets, unsigned int count, unsigned int target){
+    for(unsigned int i=0; i<count; i++){
+        if(targets[i] == target)
+            return i;
+    }
+    return -1;
+}
+
+//returns true if the call has to be issued and updates the cache
+static bool update(unsigned int& cached, unsigned int value){
+    if(s_Caching && cached == value){
+        s_Stats.skipped++;
+        return false;
+    }
+    cached = value;
+    s_Stats.issued++;
+    return true;
+}
+
+void GLState::useProgram(unsigned int program){
+    initialize();
+    if(update(s_Program, program))
+        glUseProgram(program);
+}
+
+void GLState::bindVertexArray(unsigned int vertexArray){
+    initialize();
+    if(update(s_VertexArray, vertexArray))
+        glBindVertexArray(vertexArray);
+}
+
+void GLState::bindBuffer(unsigned int target, unsigned int buffer){
+    initialize();
+    if(target == GL_ELEMENT_ARRAY_BUFFER){
+        //element buffer is only known if the bound VAO is known
+        if(s_VertexArray == Unknown){
+            s_Stats.issued++;
+            glBindBuffer(target, buffer);
+            return;
+        }
+        std::unordered_map<unsigned int, unsigned int>::iterator it = s_ElementBuffers.find(s_VertexArray);
+        if(it == s_ElementBuffers.end())
+            it = s_ElementBuffers.insert(std::make_pair(s_VertexArray, Unknown)).first;
+        if(update(it->second, buffer))
+            glBindBuffer(target, buffer);
+        return;
+    }
+
+    int index = findIndex(s_BufferTargets, BufferTargetCount, target);
+    if(index < 0){
+        s_Stats.issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if(update(s_Buffers[index], buffer))
+        glBindBuffer(target, buffer);
+}
+
+void GLState::bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer){
+    initialize();
+    if(target == GL_UNIFORM_BUFFER && index < MaxUniformBindings){
+        if(!update(s_UniformBindings[index], buffer))
+            return;
+    }
+    else{
+        s_Stats.issued++;
+    }
+    glBindBufferBase(target, index, buffer);
+
+    //binding an indexed target also replaces its generic binding
+    int generic = findIndex(s_BufferTargets, BufferTargetCount, target);
+    if(generic >= 0)
+        s_Buffers[generic] = buffer;
+}
+
+void GLState::activeTexture(unsigned int unit){
+    initialize();
+    if(update(s_ActiveUnit, unit))
+        glActiveTexture(GL_TEXTURE0+unit);
+}
+
+void GLState::bindTexture(unsigned int unit, unsigned int target, unsigned int texture){
+    initialize();
+    //the unit is always made active, callers may edit the texture after binding it
+    activeTexture(unit);
+
+    int index = findIndex(s_TextureTargets, TextureTargetCount, target);
+    if(index < 0 || unit >= MaxTextureUnits){
+        s_Stats.issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+    if(update(s_Textures[unit][index], texture))
+        glBindTexture(target, texture);
+}
+
+void GLState::bindSampler(unsigned int unit, unsigned int sampler){
+    initialize();
+    if(unit >= MaxTextureUnits){
+        s_Stats.issued++;
+        glBindSampler(unit, sampler);
+        return;
+    }
+    if(update(s_Samplers[unit], sampler))
+        glBindSampler(unit, sampler);
+}
+
+void GLState::setBlend(bool enabled){
+    initialize();
+    if(update(s_Blend, enabled ? 1 : 0)){
+        if(enabled)
+            glEnable(GL_BLEND);
+        else
+            glDisable(GL_BLEND);
+    }
+}
+
+void GLState::blendFunc(unsigned int src, unsigned int dst){
+    initialize();
+    if(s_Caching && s_BlendSrc == src && s_BlendDst == dst){
+        s_Stats.skipped++;
+        return;
+    }
+    s_BlendSrc = src;
+    s_BlendDst = dst;
+    s_Stats.issued++;
+    glBlendFunc(src, dst);
+}
+
+void GLState::viewport(int x, int y, int width, int height){
+    initialize();
+    if(s_Caching && s_ViewportValid && s_Viewport[0] == x && s_Viewport[1] == y
+        && s_Viewport[2] == width && s_Viewport[3] == height){
+        s_Stats.skipped++;
+        return;
+    }
+    s_Viewport[0] = x;
+    s_Viewport[1] = y;
+    s_Viewport[2] = width;
+    s_Viewport[3] = height;
+    s_ViewportValid = true;
+    s_Stats.issued++;
+    glViewport(x, y, width, height);
+}
+
+void GLState::programDeleted(unsigned int program){
+    if(s_Program == program)
+        s_Program = 0;
+}
+
+void GLState::vertexArrayDeleted(unsigned int vertexArray){
+    s_ElementBuffers.erase(vertexArray);
+    if(s_VertexArray == vertexArray)
+        s_VertexArray = 0;
+}
+
+void GLState::bufferDeleted(unsigned int buffer){
+    for(unsigned int i=0; i<BufferTargetCount; i++){
+        if(s_Buffers[i] == buffer)
+            s_Buffers[i] = 0;
+    }
+    for(unsigned int i=0; i<MaxUniformBindings; i++){
+        if(s_UniformBindings[i] == buffer)
+            s_UniformBindings[i] = Unknown;
+    }
+    //other VAOs keep referencing the buffer name, only the bound one is reset
+    for(std::unordered_map<unsigned int, unsigned int>::iterator it=s_ElementBuffers.begin(); it!=s_ElementBuffers.end(); ++it){
+        if(it->second == buffer)
+            it->second = it->first == s_VertexArray ? 0 : Unknown;
+    }
+}
+
+void GLState::textureDeleted(unsigned int texture){
+    for(unsigned int unit=0; unit<MaxTextureUnits; unit++){
+        for(unsigned int i=0; i<TextureTargetCount; i++){
+            if(s_Textures[unit][i] == texture)
+                s_Textures[unit][i] = 0;
+        }
+    }
+}
+
+void GLState::samplerDeleted(unsigned int sampler){
+    for(unsigned int unit=0; unit<MaxTextureUnits; unit++){
+        if(s_Samplers[unit] == sampler)
+            s_Samplers[unit] = 0;
+    }
+}
+
+void GLState::invalidate(){
+    s_Program = Unknown;
+    s_VertexArray = Unknown;
+    for(unsigned int i=0; i<BufferTargetCount; i++)
+        s_Buffers[i] = Unknown;
+    s_ElementBuffers.clear();
+    for(unsigned int i=0; i<MaxUniformBindings; i++)
+        s_UniformBindings[i] = Unknown;
+    s_ActiveUnit = Unknown;
+    for(unsigned int unit=0; unit<MaxTextureUnits; unit++){
+        for(unsigned int i=0; i<TextureTargetCount; i++)
+            s_Textures[unit][i] = Unknown;
+        s_Samplers[unit] = Unknown;
+    }
+    s_Blend = Unknown;
+    s_BlendSrc = Unknown;
+    s_BlendDst = Unknown;
+    s_ViewportValid = false;
+}
+
+void GLState::setCaching(bool enabled){
+    s_Caching = enabled;
+}
+
+bool GLState::isCaching(){
+    return s_Caching;
+}
+
+const GLState::Stats& GLState::getStats(){
+    return s_Stats;
+}
+
+void GLState::resetStats(){
+    s_Stats.issued = 0;
+    s_Stats.skipped = 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+//Process-wide cache of the bound GL objects and a few pieces of fixed
+//function state. Binds go through here so calls that would not change
+//anything never reach the driver. All classes bind through GLState, raw
+//glBind* calls elsewhere must be followed by invalidate().
+class GLState{
+public:
+    struct Stats{
+        unsigned int issued;    //calls passed on to the driver
+        unsigned int skipped;   //redundant calls that were filtered out
+    };
+
+    static void useProgram(unsigned int program);
+    static void bindVertexArray(unsigned int vertexArray);
+    static void bindBuffer(unsigned int target, unsigned int buffer);
+    static void bindBufferBase(unsigned int target, unsigned int index, unsigned int buffer);
+    static void activeTexture(unsigned int unit);
+    static void bindTexture(unsigned int unit, unsigned int target, unsigned int texture);
+    static void bindSampler(unsigned int unit, unsigned int sampler);
+
+    static void setBlend(bool enabled);
+    static void blendFunc(unsigned int src, unsigned int dst);
+    static void viewport(int x, int y, int width, int height);
+
+    //deleted objects are unbound by GL, keep the cache in sync
+    static void programDeleted(unsigned int program);
+    static void vertexArrayDeleted(unsigned int vertexArray);
+    static void bufferDeleted(unsigned int buffer);
+    static void textureDeleted(unsigned int texture);
+    static void samplerDeleted(unsigned int sampler);
+
+    //forget all cached state, e.g. after a context switch
+    static void invalidate();
+
+    //with caching disabled every call is issued (for benchmarks)
+    static void setCaching(bool enabled);
+    static bool isCaching();
+
+    static const Stats& getStats();
+    static void resetStats();
+};
@@ -0,0 +1,109 @@
+#include "HeadlessContext.h"
+
+#include <stdio.h>
+#include <GL/glew.h>
+#include <EGL/eglext.h>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+static EGLDisplay getDisplay(){
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if(getPlatformDisplay){
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if(display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+            return display;
+    }
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if(display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr))
+        return display;
+    return EGL_NO_DISPLAY;
+}
+
+static EGLContext createContext(EGLDisplay display, EGLConfig config, bool debug){
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_CONTEXT_OPENGL_DEBUG, debug ? EGL_TRUE : EGL_FALSE,
+        EGL_NONE
+    };
+    return eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+}
+
+HeadlessContext::HeadlessContext(int width, int height)
+    : m_Display(EGL_NO_DISPLAY), m_Surface(EGL_NO_SURFACE), m_Context(EGL_NO_CONTEXT),
+      m_Width(width), m_Height(height), m_Valid(false)
+{
+    m_Display = getDisplay();
+    if(m_Display == EGL_NO_DISPLAY){
+        fprintf(stderr, "EGL could not initialize\n");
+        return;
+    }
+    eglBindAPI(EGL_OPENGL_API);
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint configCount = 0;
+    if(!eglChooseConfig(m_Display, configAttribs, &config, 1, &configCount) || configCount == 0){
+        fprintf(stderr, "No matching EGL config\n");
+        return;
+    }
+
+    //debug builds ask for a debug context for GLDebug, without it if the driver refuses
+#ifndef NDEBUG
+    m_Context = createContext(m_Display, config, true);
+#endif
+    if(m_Context == EGL_NO_CONTEXT)
+        m_Context = createContext(m_Display, config, false);
+    if(m_Context == EGL_NO_CONTEXT){
+        fprintf(stderr, "Error creating EGL context\n");
+        return;
+    }
+
+    //surfaceless if the driver supports it, otherwise a small pbuffer
+    if(!eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_Context)){
+        const EGLint pbufferAttribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+        m_Surface = eglCreatePbufferSurface(m_Display, config, pbufferAttribs);
+        if(!eglMakeCurrent(m_Display, m_Surface, m_Surface, m_Context)){
+            fprintf(stderr, "Error making EGL context current\n");
+            return;
+        }
+    }
+
+    // ----- GLEW (a GLX-only GLEW reports the missing X display, the GL entry points are loaded anyway)
+    glewExperimental = GL_TRUE;
+    GLenum result = glewInit();
+    if(result != GLEW_OK && result != GLEW_ERROR_NO_GLX_DISPLAY){
+        fprintf(stderr, "Error in GLEW-Initalisation\n");
+        return;
+    }
+
+    m_FrameBuffer.reset(new FrameBuffer(width, height));
+    if(!m_FrameBuffer->isComplete()){
+        fprintf(stderr, "Offscreen framebuffer incomplete\n");
+        return;
+    }
+    m_FrameBuffer->bind();
+
+    m_Valid = true;
+}
+
+HeadlessContext::~HeadlessContext(){
+    if(m_Context != EGL_NO_CONTEXT){
+        m_FrameBuffer.reset();
+        eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(m_Display, m_Context);
+    }
+    if(m_Surface != EGL_NO_SURFACE)
+        eglDestroySurface(m_Display, m_Surface);
+    if(m_Display != EGL_NO_DISPLAY)
+        eglTerminate(m_Display);
+}
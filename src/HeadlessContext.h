@@ -0,0 +1,28 @@
+#pragma once
+#include <memory>
+#include <EGL/egl.h>
+
+#include "FrameBuffer.h"
+
+//OpenGL 3.3 core context without a window (EGL surfaceless, pbuffer as
+//fallback), a debug context unless NDEBUG is defined. Rendering goes into an offscreen framebuffer of the given size,
+//so it also works on Mesa llvmpipe without a display. The framebuffer is
+//bound after construction.
+class HeadlessContext{
+private:
+    EGLDisplay m_Display;
+    EGLSurface m_Surface;
+    EGLContext m_Context;
+    std::unique_ptr<FrameBuffer> m_FrameBuffer;   //created once the context is current
+    int m_Width, m_Height;
+    bool m_Valid;
+
+public:
+    HeadlessContext(int width, int height);
+    ~HeadlessContext();
+
+    inline bool isValid() const {return m_Valid;}
+    inline int getWidth() const {return m_Width;}
+    inline int getHeight() const {return m_Height;}
+    inline FrameBuffer& getFrameBuffer() {return *m_FrameBuffer;}
+};
@@ -0,0 +1,338 @@
+#include "ImageCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <algorithm>
+#include <vector>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#include <sys/utime.h>
+#else
+#include <dirent.h>
+#include <utime.h>
+#endif
+
+#include "stb_image.h"
+#include "AssetPack.h"
+
+//two independent 64 bit hashes of the contents, the size and the flip
+struct ImageKey{
+    uint64_t hash;
+    uint64_t check;
+
+    inline bool operator==(const ImageKey& other) const {return hash == other.hash && check == other.check;}
+};
+
+struct ImageKeyHash{
+    inline size_t operator()(const ImageKey& key) const {return (size_t)key.hash;}
+};
+
+struct DiskHeader{
+    char magic[4];
+    uint32_t version;
+    ImageKey key;
+    int32_t width, height, bpp;
+    uint32_t reserved;
+};
+
+static const char s_Magic[4] = {'I', 'M', 'G', 'C'};
+static const uint32_t CacheVersion = 2;
+
+struct CacheEntry{
+    std::shared_ptr<const DecodedImage> image;
+    std::list<ImageKey>::iterator lru;
+};
+
+static std::mutex s_Mutex;
+static std::unordered_map<ImageKey, CacheEntry, ImageKeyHash> s_Entries;
+static std::list<ImageKey> s_Lru;       //most recently used first
+static size_t s_Budget = 256*1024*1024;
+static std::string s_Directory = ".imagecache";
+static bool s_DiskEnabled = false;
+static size_t s_DiskBudget = 1024ull*1024*1024;
+static ImageCache::Stats s_Stats = {0, 0, 0, 0, 0};
+
+DecodedImage::~DecodedImage(){
+    stbi_image_free(pixels);
+}
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size){
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t i=0; i<size; i++){
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+//murmur3's finalizer, every input bit affects every output bit
+static uint64_t fmix64(uint64_t hash){
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+//byte-wise FNV-1a and a multiply-rotate hash over 8 byte words, both start
+//with the size and the flip. Hashing is still much cheaper than decoding.
+static ImageKey hashContents(const unsigned char* data, size_t size, bool flipVertically){
+    const uint64_t header[2] = {(uint64_t)size, flipVertically ? 1ull : 0ull};
+    ImageKey key;
+    key.hash = fnv1a(14695981039346656037ull, header, sizeof(header));
+    key.hash = fnv1a(key.hash, data, size);
+
+    uint64_t check = fmix64(header[0]*2+header[1]);
+    size_t i = 0;
+    for(; i+8 <= size; i+=8){
+        uint64_t word;
+        memcpy(&word, data+i, sizeof(word));
+        word *= 0x87c37b91114253d5ull;
+        word = (word << 31) | (word >> 33);
+        check ^= word*0x4cf5ad432745937full;
+        check = ((check << 27) | (check >> 37))*5+0x52dce729;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, data+i, size-i);
+    key.check = fmix64(check ^ fmix64(tail ^ size));
+    return key;
+}
+
+static std::string entryPath(const std::string& directory, const ImageKey& key){
+    char name[48];
+    snprintf(name, sizeof(name), "/%016llx%016llx.rgba", (unsigned long long)key.hash, (unsigned long long)key.check);
+    return directory+name;
+}
+
+static void makeDirectory(const std::string& path){
+#ifdef _WIN32
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+static DecodedImage* loadFromDisk(const std::string& directory, const ImageKey& key){
+    std::string path = entryPath(directory, key);
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file)
+        return nullptr;
+
+    DiskHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, s_Magic, sizeof(s_Magic)) == 0
+        && header.version == CacheVersion
+        && header.key == key
+        && header.width > 0 && header.height > 0;
+    DecodedImage* image = nullptr;
+    if(valid){
+        image = new DecodedImage();
+        image->width = header.width;
+        image->height = header.height;
+        image->bpp = header.bpp;
+        //malloc, stbi_image_free() frees it like decoded pixels
+        image->pixels = (unsigned char*)malloc(image->getSize());
+        valid = image->pixels && fread(image->pixels, 1, image->getSize(), file) == image->getSize();
+    }
+    fclose(file);
+
+    if(!valid){
+        delete image;
+        remove(path.c_str());
+        return nullptr;
+    }
+    //the modification time orders the entries for pruneDisk()
+    utime(path.c_str(), nullptr);
+    return image;
+}
+
+static void storeToDisk(const std::string& directory, const ImageKey& key, const DecodedImage& image){
+    DiskHeader header;
+    memcpy(header.magic, s_Magic, sizeof(s_Magic));
+    header.version = CacheVersion;
+    header.key = key;
+    header.width = image.width;
+    header.height = image.height;
+    header.bpp = image.bpp;
+    header.reserved = 0;
+
+    makeDirectory(directory);
+    //write to a temporary file first, so a crash never leaves half an entry
+    std::string path = entryPath(directory, key);
+    std::string tempPath = path+".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if(!file)
+        return;
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(image.pixels, 1, image.getSize(), file) == image.getSize();
+    fclose(file);
+
+    if(written)
+        written = rename(tempPath.c_str(), path.c_str()) == 0;
+    if(!written)
+        remove(tempPath.c_str());
+}
+
+//deletes the least recently used entries until the directory fits the budget.
+//Every content change of an image leaves its old entry behind, this is what
+//removes them. Not implemented on Windows.
+static void pruneDisk(const std::string& directory, size_t budget){
+#ifndef _WIN32
+    struct DiskEntry{
+        std::string path;
+        time_t used;
+        size_t size;
+    };
+    DIR* dir = opendir(directory.c_str());
+    if(!dir)
+        return;
+    std::vector<DiskEntry> entries;
+    size_t total = 0;
+    while(dirent* child = readdir(dir)){
+        std::string name = child->d_name;
+        if(name.size() < 5 || name.compare(name.size()-5, 5, ".rgba") != 0)
+            continue;
+        DiskEntry entry;
+        entry.path = directory+"/"+name;
+        struct stat info;
+        if(stat(entry.path.c_str(), &info) != 0)
+            continue;
+        entry.used = info.st_mtime;
+        entry.size = info.st_size;
+        total += entry.size;
+        entries.push_back(entry);
+    }
+    closedir(dir);
+    if(total <= budget)
+        return;
+
+    std::sort(entries.begin(), entries.end(), [](const DiskEntry& a, const DiskEntry& b){
+        return a.used < b.used;
+    });
+    for(unsigned int i=0; i<entries.size() && total > budget; i++){
+        if(remove(entries[i].path.c_str()) == 0)
+            total -= entries[i].size;
+    }
+#endif
+}
+
+//drops unused images from the back of the LRU list until the cache fits its budget, s_Mutex must be locked
+static void evict(size_t budget){
+    auto it = s_Lru.end();
+    while(s_Stats.size > budget && it != s_Lru.begin()){
+        --it;
+        auto entry = s_Entries.find(*it);
+        //only the cache holds it, nobody can get another reference without s_Mutex
+        if(entry->second.image.use_count() == 1){
+            s_Stats.size -= entry->second.image->getSize();
+            s_Stats.imageCount--;
+            s_Entries.erase(entry);
+            it = s_Lru.erase(it);
+        }
+    }
+}
+
+std::shared_ptr<const DecodedImage> ImageCache::load(const std::string& path, bool flipVertically){
+    AssetFile file(path);
+    if(!file.isOpen()){
+        //sets stbi_failure_reason()
+        int width, height, bpp;
+        stbi_image_free(loadImage(path, width, height, bpp, flipVertically));
+        return nullptr;
+    }
+
+    const ImageKey key = hashContents(file.getData(), file.getSize(), flipVertically);
+    bool diskEnabled;
+    std::string directory;
+    size_t diskBudget;
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        auto it = s_Entries.find(key);
+        if(it != s_Entries.end()){
+            s_Lru.splice(s_Lru.begin(), s_Lru, it->second.lru);
+            s_Stats.hits++;
+            return it->second.image;
+        }
+        diskEnabled = s_DiskEnabled;
+        directory = s_Directory;
+        diskBudget = s_DiskBudget;
+    }
+
+    DecodedImage* decoded = diskEnabled ? loadFromDisk(directory, key) : nullptr;
+    bool fromDisk = decoded != nullptr;
+    if(!decoded){
+        decoded = new DecodedImage();
+        decoded->pixels = decodeImage(file.getData(), file.getSize(), decoded->width, decoded->height, decoded->bpp, flipVertically);
+        if(!decoded->pixels){
+            delete decoded;
+            return nullptr;
+        }
+        if(diskEnabled){
+            storeToDisk(directory, key, *decoded);
+            pruneDisk(directory, diskBudget);
+        }
+    }
+    std::shared_ptr<const DecodedImage> image(decoded);
+
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    if(fromDisk)
+        s_Stats.diskHits++;
+    else
+        s_Stats.misses++;
+
+    //another thread was faster, share its copy
+    auto it = s_Entries.find(key);
+    if(it != s_Entries.end())
+        return it->second.image;
+
+    s_Lru.push_front(key);
+    s_Entries[key] = {image, s_Lru.begin()};
+    s_Stats.size += image->getSize();
+    s_Stats.imageCount++;
+    evict(s_Budget);
+    return image;
+}
+
+void ImageCache::setBudget(size_t bytes){
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Budget = bytes;
+    evict(s_Budget);
+}
+
+void ImageCache::setDirectory(const std::string& directory){
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Directory = directory;
+}
+
+void ImageCache::setDiskCacheEnabled(bool enabled){
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_DiskEnabled = enabled;
+}
+
+void ImageCache::setDiskBudget(size_t bytes){
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_DiskBudget = bytes;
+}
+
+void ImageCache::clear(){
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    evict(0);
+}
+
+ImageCache::Stats ImageCache::getStats(){
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    return s_Stats;
+}
+
+void ImageCache::resetStats(){
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    s_Stats.hits = 0;
+    s_Stats.diskHits = 0;
+    s_Stats.misses = 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+//RGBA8 pixels of a decoded image, shared by everyone who loaded it
+struct DecodedImage{
+    int width, height;
+    int bpp;                    //channels in the file
+    unsigned char* pixels;      //owned, from stb_image or the disk cache
+
+    DecodedImage() : width(0), height(0), bpp(0), pixels(nullptr) {}
+    ~DecodedImage();
+    DecodedImage(const DecodedImage&) = delete;
+    DecodedImage& operator=(const DecodedImage&) = delete;
+
+    inline size_t getSize() const {return (size_t)width*height*4;}
+};
+
+//Process-wide cache of decoded images, keyed by a hash of the file contents
+//and the flip, so loading the same image again (for another texture, from
+//another path or after the file was replaced) never decodes a stale or
+//duplicate copy. Images are reference counted through shared_ptr. Once the
+//cache is over budget, images nobody holds anymore are dropped, least
+//recently used first. Optionally decoded pixels are also written to a
+//directory, so a warm start reads them instead of decoding. Thread-safe, two
+//threads that miss on the same image at once both decode it.
+class ImageCache{
+public:
+    struct Stats{
+        unsigned int hits;          //in memory
+        unsigned int diskHits;
+        unsigned int misses;        //decoded
+        unsigned int imageCount;
+        size_t size;                //bytes of all cached images
+    };
+
+    //nullptr if the image can't be read or decoded, stbi_failure_reason() tells why
+    static std::shared_ptr<const DecodedImage> load(const std::string& path, bool flipVertically=true);
+
+    static void setBudget(size_t bytes);                         //default 256 MB
+    static void setDirectory(const std::string& directory);      //default ".imagecache"
+    static void setDiskCacheEnabled(bool enabled);               //default off
+    //default 1 GB, the least recently used entries are deleted after a store exceeds it
+    static void setDiskBudget(size_t bytes);
+
+    //drops all images nobody holds
+    static void clear();
+
+    static Stats getStats();
+    static void resetStats();
+};
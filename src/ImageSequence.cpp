@@ -0,0 +1,118 @@
+#include "ImageSequence.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+static void makeDirectory(const std::string& path){
+#ifdef _WIN32
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+bool ImageSequence::writeTga(const std::string& path, int width, int height, const unsigned char* pixels){
+    FILE* file = fopen(path.c_str(), "wb");
+    if(!file)
+        return false;
+
+    unsigned char header[18];
+    memset(header, 0, sizeof(header));
+    header[2] = 2;                  //uncompressed true color
+    header[12] = width & 0xFF;
+    header[13] = (width >> 8) & 0xFF;
+    header[14] = height & 0xFF;
+    header[15] = (height >> 8) & 0xFF;
+    header[16] = 32;
+    header[17] = 8;                 //alpha bits, origin bit clear = bottom row first
+
+    size_t size = (size_t)width*height*4;
+    bool written = fwrite(header, 1, sizeof(header), file) == sizeof(header)
+        && fwrite(pixels, 1, size, file) == size;
+    return fclose(file) == 0 && written;
+}
+
+ImageSequence::ImageSequence(const std::string& directory, const std::string& prefix)
+    : m_Directory(directory), m_Prefix(prefix), m_Writing(false), m_Stop(false), m_Written(0), m_Failed(0)
+{
+    makeDirectory(m_Directory);
+    m_Writer = std::thread(&ImageSequence::writerMain, this);
+}
+
+ImageSequence::~ImageSequence(){
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_QueuedCondition.notify_all();
+    m_Writer.join();
+}
+
+std::string ImageSequence::getPath(unsigned int index) const{
+    char name[32];
+    snprintf(name, sizeof(name), "_%05u.tga", index);
+    return m_Directory+"/"+m_Prefix+name;
+}
+
+void ImageSequence::add(unsigned int index, int width, int height, const unsigned char* pixels){
+    Frame frame;
+    frame.index = index;
+    frame.width = width;
+    frame.height = height;
+    frame.pixels.assign(pixels, pixels+(size_t)width*height*4);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WrittenCondition.wait(lock, [this]{return m_Queue.size() < MaxQueued;});
+    m_Queue.push_back(std::move(frame));
+    m_QueuedCondition.notify_one();
+}
+
+void ImageSequence::finish(){
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WrittenCondition.wait(lock, [this]{return m_Queue.empty() && !m_Writing;});
+}
+
+unsigned int ImageSequence::getWrittenCount(){
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Written;
+}
+
+unsigned int ImageSequence::getFailedCount(){
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Failed;
+}
+
+void ImageSequence::writerMain(){
+    while(true){
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_QueuedCondition.wait(lock, [this]{return m_Stop || !m_Queue.empty();});
+            if(m_Queue.empty())
+                return;
+            frame = std::move(m_Queue.front());
+            m_Queue.pop_front();
+            m_Writing = true;
+        }
+
+        std::string path = getPath(frame.index);
+        bool written = writeTga(path, frame.width, frame.height, &frame.pixels[0]);
+        if(!written)
+            std::cout << "Failed to write '" << path << "'" << std::endl;
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Writing = false;
+            if(written)
+                m_Written++;
+            else
+                m_Failed++;
+        }
+        m_WrittenCondition.notify_all();
+    }
+}
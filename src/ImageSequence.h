@@ -0,0 +1,55 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Writes frames as numbered TGA files (<directory>/<prefix>_00000.tga) on a
+//background thread. add() copies the pixels, so it can be called straight
+//from a FrameReader callback. At most MaxQueued frames wait for the disk,
+//add() blocks beyond that so a slow disk can't use up the memory.
+class ImageSequence{
+public:
+    static const unsigned int MaxQueued = 8;
+
+private:
+    struct Frame{
+        unsigned int index;
+        int width, height;
+        std::vector<unsigned char> pixels;
+    };
+
+    std::string m_Directory;
+    std::string m_Prefix;
+
+    std::thread m_Writer;
+    std::mutex m_Mutex;
+    std::condition_variable m_QueuedCondition;
+    std::condition_variable m_WrittenCondition;
+    std::deque<Frame> m_Queue;
+    bool m_Writing;
+    bool m_Stop;
+    unsigned int m_Written, m_Failed;
+
+    void writerMain();
+
+public:
+    //creates the directory if it doesn't exist
+    ImageSequence(const std::string& directory, const std::string& prefix="frame");
+    //writes the remaining frames
+    ~ImageSequence();
+
+    //BGRA pixels with the bottom row first, as FrameReader returns them
+    void add(unsigned int index, int width, int height, const unsigned char* pixels);
+    //blocks until every added frame is on disk
+    void finish();
+
+    std::string getPath(unsigned int index) const;
+    unsigned int getWrittenCount();
+    unsigned int getFailedCount();
+
+    //uncompressed 32 bit TGA, the origin is the lower left corner
+    static bool writeTga(const std::string& path, int width, int height, const unsigned char* pixels);
+};
@@ -1,22 +1,26 @@
 #include "IndexBuffer.h"
 #include <GL/glew.h>
+#include "GLState.h"
+#include "TraceRecorder.h"
 
 IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
     :m_Count(count)
 {
+    TraceScope trace("IndexBuffer create", "buffer");
     glGenBuffers(1,&m_RendererID);    //generate buffer and safe adress
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,m_RendererID);   //select (=bind) bufer
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER,m_RendererID);   //select (=bind) bufer
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, count*sizeof(unsigned int),data,GL_STATIC_DRAW);
 }
 
 IndexBuffer::~IndexBuffer(){
     glDeleteBuffers(1,&m_RendererID);
+    GLState::bufferDeleted(m_RendererID);
 }
 
 void IndexBuffer::bind() const{
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,m_RendererID);   //select (=bind) bufer
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER,m_RendererID);   //select (=bind) bufer
 }
 
 void IndexBuffer::unbind() const{
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER,0);   //select (=bind) bufer
+    GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER,0);   //select (=bind) bufer
 }
\ No newline at end of file
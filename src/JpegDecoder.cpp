@@ -0,0 +1,329 @@
+#include "JpegDecoder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#include "stb_image.h"
+
+//where the pieces of a baseline JPEG are, all offsets from the start of the file
+struct JpegLayout{
+    size_t heightOffset;        //frame height in the SOF segment
+    size_t scanOffset;          //first byte of the entropy coded data
+    int width, height;
+    int mcuHeight, mcusPerRow, mcuRows;
+    int restartInterval;        //in MCUs
+    bool verticalSubsampling;
+    std::vector<size_t> intervalStarts;
+    std::vector<size_t> intervalEnds;
+};
+
+struct JpegDecoder::Batch{
+    const unsigned char* data;
+    const JpegLayout* layout;
+    unsigned char* pixels;
+    bool flipVertically;
+
+    //pixel rows of the strips and the rows of MCUs that are decoded for them
+    struct Strip{
+        int firstRow, rowCount;
+        int firstMcuRow, endMcuRow;
+    };
+    std::vector<Strip> strips;
+
+    std::atomic<unsigned int> next;
+    std::mutex mutex;
+    std::condition_variable condition;
+    unsigned int done;
+    bool failed;
+    int bpp;
+
+    Batch() : next(0), done(0), failed(false), bpp(0) {}
+};
+
+static unsigned int readBigEndian16(const unsigned char* p){
+    return (p[0] << 8) | p[1];
+}
+
+static int gcd(int a, int b){
+    while(b){
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+static bool isRestartMarker(unsigned char marker){
+    return marker >= 0xD0 && marker <= 0xD7;
+}
+
+static bool parseLayout(const unsigned char* data, size_t size, JpegLayout& layout){
+    if(size < 4 || data[0] != 0xFF || data[1] != 0xD8)
+        return false;
+
+    int componentCount = 0;
+    int maxH = 1, maxV = 1;
+    unsigned char sampling[4];
+    layout.heightOffset = 0;
+    layout.restartInterval = 0;
+
+    size_t pos = 2;
+    while(true){
+        if(pos+4 > size || data[pos] != 0xFF)
+            return false;
+        while(pos+4 <= size && data[pos+1] == 0xFF)    //fill bytes
+            pos++;
+        if(pos+4 > size)
+            return false;
+        unsigned char marker = data[pos+1];
+        pos += 2;
+        size_t length = readBigEndian16(data+pos);
+        if(length < 2 || pos+length > size)
+            return false;
+        const unsigned char* segment = data+pos+2;
+
+        if(marker == 0xC0 || marker == 0xC1){
+            //8 bit huffman coded frame, at most 4 components
+            if(length < 8 || segment[0] != 8)
+                return false;
+            layout.heightOffset = pos+3;
+            layout.height = readBigEndian16(segment+1);
+            layout.width = readBigEndian16(segment+3);
+            componentCount = segment[5];
+            if(componentCount < 1 || componentCount > 4 || length < 8+3u*componentCount || layout.width == 0 || layout.height == 0)
+                return false;
+            for(int i=0; i<componentCount; i++){
+                sampling[i] = segment[6+i*3+1];
+                maxH = std::max(maxH, sampling[i] >> 4);
+                maxV = std::max(maxV, sampling[i] & 15);
+            }
+        }
+        else if(marker >= 0xC2 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC){
+            //progressive, lossless or arithmetic coded
+            return false;
+        }
+        else if(marker == 0xDD){
+            if(length < 4)
+                return false;
+            layout.restartInterval = readBigEndian16(segment);
+        }
+        else if(marker == 0xDA){
+            //one interleaved scan with all components
+            if(layout.heightOffset == 0 || length < 3 || segment[0] != componentCount)
+                return false;
+            layout.scanOffset = pos+length;
+            break;
+        }
+        pos += length;
+    }
+    if(layout.restartInterval == 0)
+        return false;
+
+    //a single component scan isn't interleaved, its MCU is one block
+    if(componentCount == 1)
+        maxH = maxV = 1;
+    layout.verticalSubsampling = false;
+    for(int i=0; i<componentCount && componentCount > 1; i++)
+        layout.verticalSubsampling = layout.verticalSubsampling || (sampling[i] & 15) != maxV;
+    layout.mcuHeight = maxV*8;
+    layout.mcusPerRow = (layout.width + maxH*8-1) / (maxH*8);
+    layout.mcuRows = (layout.height + layout.mcuHeight-1) / layout.mcuHeight;
+
+    //every restart marker ends an interval, any other marker ends the scan
+    layout.intervalStarts.assign(1, layout.scanOffset);
+    layout.intervalEnds.clear();
+    size_t scanEnd = size;
+    pos = layout.scanOffset;
+    while(pos+1 < size){
+        const unsigned char* ff = (const unsigned char*)memchr(data+pos, 0xFF, size-1-pos);
+        if(!ff)
+            break;
+        pos = ff-data;
+        unsigned char marker = data[pos+1];
+        if(marker == 0x00){
+            pos += 2;
+        }
+        else if(marker == 0xFF){
+            pos++;
+        }
+        else if(isRestartMarker(marker)){
+            layout.intervalEnds.push_back(pos);
+            pos += 2;
+            layout.intervalStarts.push_back(pos);
+        }
+        else{
+            scanEnd = pos;
+            break;
+        }
+    }
+    layout.intervalEnds.push_back(scanEnd);
+
+    size_t mcuCount = (size_t)layout.mcusPerRow*layout.mcuRows;
+    return layout.intervalStarts.size() == (mcuCount + layout.restartInterval-1) / layout.restartInterval;
+}
+
+//decodes a strip as its own JPEG: the headers with a shorter frame, the
+//restart intervals of the strip and an end marker
+static unsigned char* decodeStrip(const unsigned char* data, const JpegLayout& layout, int firstMcuRow, int endMcuRow, int& bpp){
+    size_t firstInterval = (size_t)firstMcuRow*layout.mcusPerRow / layout.restartInterval;
+    size_t endInterval = endMcuRow == layout.mcuRows ? layout.intervalStarts.size() : (size_t)endMcuRow*layout.mcusPerRow / layout.restartInterval;
+    size_t begin = layout.intervalStarts[firstInterval];
+    size_t end = layout.intervalEnds[endInterval-1];
+    int height = std::min(endMcuRow*layout.mcuHeight, layout.height) - firstMcuRow*layout.mcuHeight;
+
+    std::vector<unsigned char> jpeg(layout.scanOffset + (end-begin) + 2);
+    memcpy(&jpeg[0], data, layout.scanOffset);
+    jpeg[layout.heightOffset] = (unsigned char)(height >> 8);
+    jpeg[layout.heightOffset+1] = (unsigned char)(height & 0xFF);
+    memcpy(&jpeg[layout.scanOffset], data+begin, end-begin);
+    jpeg[jpeg.size()-2] = 0xFF;
+    jpeg[jpeg.size()-1] = 0xD9;
+
+    int width, stripHeight;
+    unsigned char* pixels = stbi_load_from_memory(&jpeg[0], (int)jpeg.size(), &width, &stripHeight, &bpp, 4);
+    if(pixels && (width != layout.width || stripHeight != height)){
+        stbi_image_free(pixels);
+        return nullptr;
+    }
+    return pixels;
+}
+
+//layout and pixels belong to the caller of decode(), they are only valid while a strip is claimed
+void JpegDecoder::run(Batch& batch){
+    unsigned int index;
+    while((index = batch.next++) < batch.strips.size()){
+        const JpegLayout& layout = *batch.layout;
+        const size_t rowSize = (size_t)layout.width*4;
+        const Batch::Strip& strip = batch.strips[index];
+        int bpp = 0;
+        unsigned char* pixels = decodeStrip(batch.data, layout, strip.firstMcuRow, strip.endMcuRow, bpp);
+        if(pixels){
+            const unsigned char* src = pixels + (size_t)(strip.firstRow - strip.firstMcuRow*layout.mcuHeight)*rowSize;
+            for(int y=strip.firstRow; y<strip.firstRow+strip.rowCount; y++, src+=rowSize){
+                int row = batch.flipVertically ? layout.height-1-y : y;
+                memcpy(batch.pixels + row*rowSize, src, rowSize);
+            }
+            stbi_image_free(pixels);
+        }
+
+        std::lock_guard<std::mutex> lock(batch.mutex);
+        batch.failed = batch.failed || !pixels;
+        batch.bpp = bpp;
+        if(++batch.done == batch.strips.size())
+            batch.condition.notify_all();
+    }
+}
+
+JpegDecoder::JpegDecoder(unsigned int threadCount)
+    : m_Stop(false)
+{
+    if(threadCount == 0){
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = cores > 1 ? cores-1 : 0;
+    }
+    for(unsigned int i=0; i<threadCount; i++)
+        m_Workers.push_back(std::thread(&JpegDecoder::workerMain, this));
+}
+
+JpegDecoder::~JpegDecoder(){
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Condition.notify_all();
+    for(unsigned int i=0; i<m_Workers.size(); i++)
+        m_Workers[i].join();
+}
+
+void JpegDecoder::workerMain(){
+    //strips are copied in the caller's orientation
+    stbi_set_flip_vertically_on_load_thread(0);
+
+    while(true){
+        std::shared_ptr<Batch> batch;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(lock, [this]{return m_Stop || !m_Batches.empty();});
+            if(m_Stop)
+                return;
+            //stays queued so other workers join in
+            batch = m_Batches.front();
+        }
+
+        run(*batch);
+
+        //all strips are taken, the batch may still be running on other threads
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = std::find(m_Batches.begin(), m_Batches.end(), batch);
+        if(it != m_Batches.end())
+            m_Batches.erase(it);
+    }
+}
+
+unsigned char* JpegDecoder::decode(const unsigned char* data, size_t size, int& width, int& height, int& bpp, bool flipVertically){
+    if(m_Workers.empty())
+        return nullptr;
+    JpegLayout layout;
+    if(!parseLayout(data, size, layout) || (size_t)layout.width*layout.height < (size_t)MinPixels)
+        return nullptr;
+
+    //strips can only start where a restart interval starts a row of MCUs
+    int step = layout.restartInterval / gcd(layout.restartInterval, layout.mcusPerRow);
+    int overlap = layout.verticalSubsampling ? step : 0;
+    int stripCount = std::min((int)getThreadCount(), layout.mcuRows / step);
+    if(stripCount < 2)
+        return nullptr;
+    int stripMcuRows = (layout.mcuRows/step + stripCount-1) / stripCount * step;
+
+    std::shared_ptr<Batch> batch(new Batch());
+    batch->data = data;
+    batch->layout = &layout;
+    batch->flipVertically = flipVertically;
+    batch->pixels = (unsigned char*)malloc((size_t)layout.width*layout.height*4);
+    if(!batch->pixels)
+        return nullptr;
+    for(int row=0; row<layout.mcuRows; row+=stripMcuRows){
+        int end = std::min(row+stripMcuRows, layout.mcuRows);
+        Batch::Strip strip;
+        strip.firstRow = row*layout.mcuHeight;
+        strip.rowCount = std::min(end*layout.mcuHeight, layout.height) - strip.firstRow;
+        strip.firstMcuRow = std::max(row-overlap, 0);
+        strip.endMcuRow = std::min(end+overlap, layout.mcuRows);
+        batch->strips.push_back(strip);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Batches.push_back(batch);
+    }
+    m_Condition.notify_all();
+
+    stbi_set_flip_vertically_on_load_thread(0);
+    run(*batch);
+    {
+        std::unique_lock<std::mutex> lock(batch->mutex);
+        batch->condition.wait(lock, [&batch]{return batch->done == batch->strips.size();});
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        auto it = std::find(m_Batches.begin(), m_Batches.end(), batch);
+        if(it != m_Batches.end())
+            m_Batches.erase(it);
+    }
+
+    if(batch->failed){
+        free(batch->pixels);
+        return nullptr;
+    }
+    width = layout.width;
+    height = layout.height;
+    bpp = batch->bpp;
+    return batch->pixels;
+}
+
+JpegDecoder& JpegDecoder::getShared(){
+    static JpegDecoder decoder;
+    return decoder;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Decodes one large baseline JPEG on several threads. The entropy coded scan
+//is split at restart markers that start a row of MCUs and every strip is
+//decoded by stb_image as a standalone JPEG with the same tables. Strips
+//overlap by a row of MCUs when chroma is subsampled vertically, so the
+//upsampling at the seams sees the same neighbours and the image is the same
+//as the one stb_image decodes on one thread.
+class JpegDecoder{
+public:
+    //smaller images aren't worth waking up the workers
+    static const int MinPixels = 512*512;
+
+private:
+    struct Batch;
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::deque<std::shared_ptr<Batch>> m_Batches;
+    bool m_Stop;
+
+    static void run(Batch& batch);
+    void workerMain();
+
+public:
+    //threadCount 0 uses one thread less than there are cores, the calling
+    //thread decodes strips as well
+    JpegDecoder(unsigned int threadCount=0);
+    ~JpegDecoder();
+
+    //RGBA8, free the result with stbi_image_free(). Returns nullptr if the
+    //image can't be split (progressive, no restart markers, too small) or
+    //there are no workers, decode it with stb_image then.
+    //Resets stb_image's flip flag of the calling thread.
+    unsigned char* decode(const unsigned char* data, size_t size, int& width, int& height, int& bpp, bool flipVertically);
+
+    inline unsigned int getThreadCount() const {return m_Workers.size()+1;}
+
+    //used by loadImage()
+    static JpegDecoder& getShared();
+};
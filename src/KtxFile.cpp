@@ -0,0 +1,107 @@
+#include "KtxFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <GL/glew.h>
+
+KtxFile::KtxFile(){
+    memset(&m_Header, 0, sizeof(m_Header));
+}
+
+bool KtxFile::load(const std::string& path){
+    m_Levels.clear();
+    if(parse(path))
+        return true;
+
+    m_File.close();
+    m_Levels.clear();
+    return false;
+}
+
+bool KtxFile::parse(const std::string& path){
+    if(!m_File.open(path)){
+        std::cout << "Failed to open '" << path << "'" << std::endl;
+        return false;
+    }
+    const unsigned char* data = m_File.getData();
+    const size_t size = m_File.getSize();
+
+    if(size < sizeof(KtxHeader)){
+        std::cout << "'" << path << "' is not a KTX file" << std::endl;
+        return false;
+    }
+    memcpy(&m_Header, data, sizeof(KtxHeader));
+    if(memcmp(m_Header.identifier, KtxIdentifier, sizeof(KtxIdentifier)) != 0){
+        std::cout << "'" << path << "' is not a KTX file" << std::endl;
+        return false;
+    }
+    if(m_Header.endianness != KtxEndianness){
+        std::cout << "'" << path << "' has the wrong endianness" << std::endl;
+        return false;
+    }
+    if(m_Header.pixelDepth > 1 || m_Header.numberOfArrayElements > 0 || m_Header.numberOfFaces != 1){
+        std::cout << "'" << path << "' is not a 2D texture" << std::endl;
+        return false;
+    }
+
+    unsigned int levelCount = m_Header.numberOfMipmapLevels > 0 ? m_Header.numberOfMipmapLevels : 1;
+    //a full chain ends at 1x1, more levels are invalid and would shift the size past 32 bits
+    unsigned int maxLevelCount = 1;
+    for(uint32_t extent = std::max(m_Header.pixelWidth, m_Header.pixelHeight); extent > 1; extent >>= 1)
+        maxLevelCount++;
+    if(m_Header.pixelWidth == 0 || levelCount > maxLevelCount){
+        std::cout << "'" << path << "' has invalid dimensions or mip levels" << std::endl;
+        return false;
+    }
+    size_t offset = sizeof(KtxHeader) + m_Header.bytesOfKeyValueData;
+    for(unsigned int i=0; i<levelCount; i++){
+        uint32_t imageSize = 0;
+        if(offset+sizeof(imageSize) > size)
+            break;
+        memcpy(&imageSize, data+offset, sizeof(imageSize));
+        offset += sizeof(imageSize);
+        if(offset+imageSize > size)
+            break;
+
+        Level level;
+        level.width = std::max(m_Header.pixelWidth >> i, 1u);
+        level.height = std::max(m_Header.pixelHeight >> i, 1u);
+        level.data = data+offset;
+        level.size = imageSize;
+        m_Levels.push_back(level);
+
+        //mip padding
+        offset += (imageSize+3) & ~3u;
+    }
+    if(m_Levels.size() != levelCount){
+        std::cout << "'" << path << "' is truncated" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool KtxFile::isKtxPath(const std::string& path){
+    return path.size() >= 4 && path.compare(path.size()-4, 4, ".ktx") == 0;
+}
+
+bool KtxFile::isFormatSupported(unsigned int internalFormat){
+    switch(internalFormat){
+    case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        return GLEW_EXT_texture_compression_s3tc;
+    case GL_COMPRESSED_RGBA_BPTC_UNORM:
+    case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+        return GLEW_ARB_texture_compression_bptc;
+    case GL_COMPRESSED_RGB8_ETC2:
+    case GL_COMPRESSED_SRGB8_ETC2:
+    case GL_COMPRESSED_RGBA8_ETC2_EAC:
+    case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+        return GLEW_ARB_ES3_compatibility;
+    default:
+        //uncompressed and core formats
+        return true;
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "AssetPack.h"
+
+//KTX 1.1 header, all GL enums are stored as they are passed to GL
+struct KtxHeader{
+    uint8_t identifier[12];
+    uint32_t endianness;
+    uint32_t glType;                //0 for compressed formats
+    uint32_t glTypeSize;
+    uint32_t glFormat;              //0 for compressed formats
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t numberOfArrayElements;
+    uint32_t numberOfFaces;
+    uint32_t numberOfMipmapLevels;
+    uint32_t bytesOfKeyValueData;
+};
+
+static const uint8_t KtxIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+static const uint32_t KtxEndianness = 0x04030201;
+
+//Reads a KTX 1.1 file with a single 2D image and its mip levels, e.g. BCn or
+//ETC2 data written by tools/TextureCompressor. The file is memory mapped or
+//read from an asset pack and levels point into it, so they are uploaded
+//without another copy.
+class KtxFile{
+public:
+    struct Level{
+        unsigned int width, height;
+        const unsigned char* data;
+        unsigned int size;
+    };
+
+private:
+    AssetFile m_File;
+    KtxHeader m_Header;
+    std::vector<Level> m_Levels;
+
+    bool parse(const std::string& path);
+
+public:
+    KtxFile();
+
+    //false if the file can't be read or isn't a 2D KTX image
+    bool load(const std::string& path);
+
+    inline bool isCompressed() const {return m_Header.glType == 0;}
+    inline unsigned int getInternalFormat() const {return m_Header.glInternalFormat;}
+    inline unsigned int getFormat() const {return m_Header.glFormat;}
+    inline unsigned int getType() const {return m_Header.glType;}
+    inline unsigned int getWidth() const {return m_Header.pixelWidth;}
+    inline unsigned int getHeight() const {return m_Header.pixelHeight;}
+    inline const std::vector<Level>& getLevels() const {return m_Levels;}
+
+    static bool isKtxPath(const std::string& path);
+    //true if the driver can sample the internal format
+    static bool isFormatSupported(unsigned int internalFormat);
+};
@@ -0,0 +1,156 @@
+#include "Lz4.h"
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+
+static const size_t MinMatch = 4;
+static const size_t LastLiterals = 5;      //the last bytes are always literals
+static const size_t MatchFindLimit = 12;   //no match may start in the last bytes
+static const size_t MaxOffset = 65535;
+static const unsigned int HashBits = 16;
+
+static uint32_t read32(const unsigned char* p){
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static uint32_t hash32(uint32_t sequence){
+    return (sequence * 2654435761u) >> (32-HashBits);
+}
+
+//lengths of 15 and more continue in bytes of 255 plus a remainder
+static unsigned char* writeLength(unsigned char* op, size_t length){
+    while(length >= 255){
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = (unsigned char)length;
+    return op;
+}
+
+static unsigned char* writeSequence(unsigned char* op, const unsigned char* literals, size_t literalLength,
+    size_t offset, size_t matchLength)
+{
+    unsigned char* token = op++;
+    *token = (unsigned char)((literalLength >= 15 ? 15 : literalLength) << 4);
+    if(literalLength >= 15)
+        op = writeLength(op, literalLength-15);
+    memcpy(op, literals, literalLength);
+    op += literalLength;
+
+    //the last sequence has no match
+    if(matchLength == 0)
+        return op;
+
+    *op++ = (unsigned char)(offset & 0xFF);
+    *op++ = (unsigned char)(offset >> 8);
+    size_t length = matchLength-MinMatch;
+    *token |= (unsigned char)(length >= 15 ? 15 : length);
+    if(length >= 15)
+        op = writeLength(op, length-15);
+    return op;
+}
+
+size_t lz4CompressBound(size_t size){
+    return size + size/255 + 16;
+}
+
+size_t lz4Compress(const unsigned char* src, size_t size, unsigned char* dst){
+    unsigned char* op = dst;
+    size_t anchor = 0;
+
+    if(size > MatchFindLimit){
+        //last position of every hashed 4 byte sequence, greedy parsing
+        std::vector<int32_t> table(1u << HashBits, -1);
+        const size_t matchLimit = size-LastLiterals;
+        size_t ip = 0;
+        while(ip < size-MatchFindLimit){
+            uint32_t sequence = read32(src+ip);
+            uint32_t h = hash32(sequence);
+            int32_t ref = table[h];
+            table[h] = (int32_t)ip;
+
+            if(ref < 0 || ip-ref > MaxOffset || read32(src+ref) != sequence){
+                ip++;
+                continue;
+            }
+
+            size_t matchLength = MinMatch;
+            while(ip+matchLength < matchLimit && src[ref+matchLength] == src[ip+matchLength])
+                matchLength++;
+
+            op = writeSequence(op, src+anchor, ip-anchor, ip-ref, matchLength);
+            ip += matchLength;
+            anchor = ip;
+        }
+    }
+
+    op = writeSequence(op, src+anchor, size-anchor, 0, 0);
+    return op-dst;
+}
+
+bool lz4Decompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstSize){
+    const unsigned char* ip = src;
+    const unsigned char* const srcEnd = src+srcSize;
+    unsigned char* op = dst;
+    unsigned char* const dstEnd = dst+dstSize;
+
+    while(ip < srcEnd){
+        unsigned int token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if(literalLength == 15){
+            unsigned char byte;
+            do{
+                if(ip >= srcEnd)
+                    return false;
+                byte = *ip++;
+                literalLength += byte;
+            } while(byte == 255);
+        }
+        if(literalLength > (size_t)(srcEnd-ip) || literalLength > (size_t)(dstEnd-op))
+            return false;
+        memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        //the block ends after the literals of the last sequence
+        if(ip == srcEnd)
+            break;
+
+        if(srcEnd-ip < 2)
+            return false;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if(offset == 0 || offset > (size_t)(op-dst))
+            return false;
+
+        size_t matchLength = token & 15;
+        if(matchLength == 15){
+            unsigned char byte;
+            do{
+                if(ip >= srcEnd)
+                    return false;
+                byte = *ip++;
+                matchLength += byte;
+            } while(byte == 255);
+        }
+        matchLength += MinMatch;
+        if(matchLength > (size_t)(dstEnd-op))
+            return false;
+
+        //matches may overlap the bytes they produce
+        const unsigned char* match = op-offset;
+        if(offset >= matchLength){
+            memcpy(op, match, matchLength);
+            op += matchLength;
+        }
+        else{
+            for(size_t i=0; i<matchLength; i++)
+                *op++ = *match++;
+        }
+    }
+    return op == dstEnd;
+}
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+
+//LZ4 block format without the frame, compatible with LZ4_compress_default()
+//and LZ4_decompress_safe() of the reference library. Decompression is fast
+//enough to be cheaper than reading the uncompressed bytes from disk.
+
+//worst case size of compressing size bytes
+size_t lz4CompressBound(size_t size);
+
+//dst must hold lz4CompressBound(size) bytes, returns the compressed size
+size_t lz4Compress(const unsigned char* src, size_t size, unsigned char* dst);
+
+//false if the data is corrupt or doesn't decompress to exactly dstSize bytes
+bool lz4Decompress(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstSize);
@@ -0,0 +1,102 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : m_Data(nullptr), m_Size(0)
+#ifdef _WIN32
+    , m_File(INVALID_HANDLE_VALUE), m_Mapping(nullptr)
+#endif
+{
+}
+
+MappedFile::MappedFile(const std::string& path)
+    : MappedFile()
+{
+    open(path);
+}
+
+MappedFile::~MappedFile(){
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path){
+    close();
+    m_File = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if(m_File == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if(!GetFileSizeEx(m_File, &size) || size.QuadPart == 0){
+        close();
+        return false;
+    }
+    m_Mapping = CreateFileMappingA(m_File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(m_Mapping)
+        m_Data = (const unsigned char*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!m_Data){
+        close();
+        return false;
+    }
+    m_Size = (size_t)size.QuadPart;
+    return true;
+}
+
+void MappedFile::close(){
+    if(m_Data)
+        UnmapViewOfFile(m_Data);
+    if(m_Mapping)
+        CloseHandle(m_Mapping);
+    if(m_File != INVALID_HANDLE_VALUE)
+        CloseHandle(m_File);
+    m_Data = nullptr;
+    m_Size = 0;
+    m_Mapping = nullptr;
+    m_File = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path){
+    close();
+    int file = ::open(path.c_str(), O_RDONLY);
+    if(file < 0)
+        return false;
+
+    struct stat info;
+    if(fstat(file, &info) != 0 || info.st_size == 0){
+        ::close(file);
+        return false;
+    }
+    //the mapping keeps the file alive, the descriptor isn't needed anymore
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if(data == MAP_FAILED)
+        return false;
+
+    //decoders read the whole file front to back
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+    madvise(data, info.st_size, MADV_WILLNEED);
+    m_Data = (const unsigned char*)data;
+    m_Size = info.st_size;
+    return true;
+}
+
+void MappedFile::close(){
+    if(m_Data)
+        munmap((void*)m_Data, m_Size);
+    m_Data = nullptr;
+    m_Size = 0;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+//Read-only memory mapping of a whole file. Decoders and uploads read straight
+//from the page cache, there is no read() into a heap buffer in between.
+class MappedFile{
+private:
+    const unsigned char* m_Data;
+    size_t m_Size;
+#ifdef _WIN32
+    void* m_File;
+    void* m_Mapping;
+#endif
+
+public:
+    MappedFile();
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //false if the file can't be opened, empty files can't be mapped either
+    bool open(const std::string& path);
+    void close();
+
+    inline bool isOpen() const {return m_Data != nullptr;}
+    inline const unsigned char* getData() const {return m_Data;}
+    inline size_t getSize() const {return m_Size;}
+};
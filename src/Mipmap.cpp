@@ -0,0 +1,85 @@
+#include "Mipmap.h"
+
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+int getMipLevelCount(int width, int height){
+    int count = 1;
+    while(width > 1 || height > 1){
+        width = std::max(width/2, 1);
+        height = std::max(height/2, 1);
+        count++;
+    }
+    return count;
+}
+
+std::vector<MipLevel> getMipLevels(int width, int height){
+    std::vector<MipLevel> levels;
+    unsigned int offset = 0;
+    while(true){
+        MipLevel level = {width, height, offset, (unsigned int)(width*height*4)};
+        levels.push_back(level);
+        offset += level.size;
+        if(width == 1 && height == 1)
+            break;
+        width = std::max(width/2, 1);
+        height = std::max(height/2, 1);
+    }
+    return levels;
+}
+
+void generateMipChain(unsigned char* chain, const std::vector<MipLevel>& levels){
+    for(unsigned int i=1; i<levels.size(); i++){
+        const MipLevel& src = levels[i-1];
+        downsampleBox(chain+src.offset, src.width, src.height, chain+levels[i].offset);
+    }
+}
+
+void downsampleBox(const unsigned char* src, int width, int height, unsigned char* dst){
+    const int dstWidth = std::max(width/2, 1);
+    const int dstHeight = std::max(height/2, 1);
+    //1 pixel wide or high images average the same pixel twice
+    const int stepX = width > 1 ? 4 : 0;
+    const int stepY = height > 1 ? width*4 : 0;
+
+    for(int y=0; y<dstHeight; y++){
+        const unsigned char* row0 = src + y*2*width*4;
+        const unsigned char* row1 = row0 + stepY;
+        unsigned char* out = dst + y*dstWidth*4;
+        int x = 0;
+
+#ifdef __SSE2__
+        //4 output pixels from 2x8 input pixels, summed in 16 bit and rounded once
+        //like the scalar loop, so the result doesn't depend on the path
+        if(stepX){
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i two = _mm_set1_epi16(2);
+            for(; x+4<=dstWidth; x+=4){
+                const unsigned char* in0 = row0 + x*8;
+                const unsigned char* in1 = row1 + x*8;
+                __m128i a0 = _mm_loadu_si128((const __m128i*)in0), a1 = _mm_loadu_si128((const __m128i*)in1);
+                __m128i b0 = _mm_loadu_si128((const __m128i*)(in0+16)), b1 = _mm_loadu_si128((const __m128i*)(in1+16));
+                //vertical sums, two input pixels per register
+                __m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(a1, zero));
+                __m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(a1, zero));
+                __m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(b0, zero), _mm_unpacklo_epi8(b1, zero));
+                __m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(b0, zero), _mm_unpackhi_epi8(b1, zero));
+                //even plus odd pixel, two output pixels per register
+                __m128i lo = _mm_add_epi16(_mm_unpacklo_epi64(s0, s1), _mm_unpackhi_epi64(s0, s1));
+                __m128i hi = _mm_add_epi16(_mm_unpacklo_epi64(s2, s3), _mm_unpackhi_epi64(s2, s3));
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+                _mm_storeu_si128((__m128i*)(out + x*4), _mm_packus_epi16(lo, hi));
+            }
+        }
+#endif
+        for(; x<dstWidth; x++){
+            const unsigned char* in0 = row0 + x*2*stepX;
+            const unsigned char* in1 = row1 + x*2*stepX;
+            for(int c=0; c<4; c++)
+                out[x*4+c] = (unsigned char)((in0[c] + in0[stepX+c] + in1[c] + in1[stepX+c] + 2) >> 2);
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <vector>
+
+//one level of an RGBA8 mip chain, all levels are stored back to back
+struct MipLevel{
+    int width, height;
+    unsigned int offset;    //bytes from the start of the chain
+    unsigned int size;
+};
+
+//number of levels down to 1x1
+int getMipLevelCount(int width, int height);
+//all levels down to 1x1, offset+size of the last level is the size of the chain
+std::vector<MipLevel> getMipLevels(int width, int height);
+
+//fills every level after the first one from the level above it
+void generateMipChain(unsigned char* chain, const std::vector<MipLevel>& levels);
+
+//2x2 box filter of a RGBA8 image into one of max(width/2,1) x max(height/2,1),
+//odd sizes drop the last row or column. Uses SSE2 where available.
+void downsampleBox(const unsigned char* src, int width, int height, unsigned char* dst);
@@ -0,0 +1,94 @@
+#include "PixelBufferPool.h"
+#include "GLState.h"
+
+PixelBufferPool::PixelBufferPool(unsigned int bufferCount, unsigned int bufferSize, bool allowPersistent)
+    : m_BufferSize(bufferSize), m_Persistent(allowPersistent && GLEW_ARB_buffer_storage)
+{
+    m_Buffers.resize(bufferCount);
+    for(unsigned int i=0; i<bufferCount; i++){
+        Buffer& buffer = m_Buffers[i];
+        buffer.data = nullptr;
+        buffer.fence = nullptr;
+        glGenBuffers(1, &buffer.rendererID);
+        GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.rendererID);
+
+        if(m_Persistent){
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_BufferSize, nullptr, flags);
+            buffer.data = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_BufferSize, flags);
+        }
+        else{
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, m_BufferSize, nullptr, GL_STREAM_DRAW);
+            map(i);
+        }
+        if(buffer.data)
+            m_Free.push_back(i);
+    }
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+
+PixelBufferPool::~PixelBufferPool(){
+    //deleting a buffer also unmaps it
+    for(unsigned int i=0; i<m_Buffers.size(); i++){
+        if(m_Buffers[i].fence)
+            glDeleteSync(m_Buffers[i].fence);
+        glDeleteBuffers(1, &m_Buffers[i].rendererID);
+        GLState::bufferDeleted(m_Buffers[i].rendererID);
+    }
+}
+
+void PixelBufferPool::map(int index){
+    Buffer& buffer = m_Buffers[index];
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.rendererID);
+    buffer.data = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_BufferSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+}
+
+int PixelBufferPool::acquire(unsigned int size){
+    if(size > m_BufferSize)
+        return None;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if(m_Free.empty())
+        return None;
+    int index = m_Free.back();
+    m_Free.pop_back();
+    return index;
+}
+
+void PixelBufferPool::beginUpload(int index){
+    Buffer& buffer = m_Buffers[index];
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.rendererID);
+    if(!m_Persistent){
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        buffer.data = nullptr;
+    }
+}
+
+void PixelBufferPool::endUpload(int index){
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    m_Buffers[index].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_InFlight.push_back(index);
+}
+
+void PixelBufferPool::recycle(){
+    for(unsigned int i=0; i<m_InFlight.size(); ){
+        int index = m_InFlight[i];
+        Buffer& buffer = m_Buffers[index];
+        if(glClientWaitSync(buffer.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0) == GL_TIMEOUT_EXPIRED){
+            i++;
+            continue;
+        }
+        glDeleteSync(buffer.fence);
+        buffer.fence = nullptr;
+        m_InFlight[i] = m_InFlight.back();
+        m_InFlight.pop_back();
+
+        if(!m_Persistent)
+            map(index);
+        if(buffer.data){
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Free.push_back(index);
+        }
+    }
+    GLState::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <mutex>
+#include <vector>
+#include <GL/glew.h>
+
+//Pixel unpack buffers for texture uploads. Free buffers are kept mapped, so
+//any thread can fill one and the GL thread only issues a glTexSubImage2D that
+//reads from it, which returns without copying the pixels on the CPU. A fence
+//after each upload keeps a buffer out of the pool until the GPU has read it.
+//With ARB_buffer_storage the buffers stay persistently mapped.
+class PixelBufferPool{
+public:
+    static const int None = -1;
+
+private:
+    struct Buffer{
+        unsigned int rendererID;
+        void* data;         //nullptr while unmapped
+        GLsync fence;       //set while an upload may still read the buffer
+    };
+
+    std::vector<Buffer> m_Buffers;
+    unsigned int m_BufferSize;
+    bool m_Persistent;
+
+    std::mutex m_Mutex;
+    std::vector<int> m_Free;        //mapped and ready to be written
+    std::vector<int> m_InFlight;    //GL thread only
+
+    void map(int index);
+
+public:
+    PixelBufferPool(unsigned int bufferCount=4, unsigned int bufferSize=4*1024*1024, bool allowPersistent=true);
+    ~PixelBufferPool();
+
+    //any thread, returns a mapped buffer of at least size bytes or None if all are busy
+    int acquire(unsigned int size);
+    inline void* getData(int index) const {return m_Buffers[index].data;}
+
+    //GL thread, binds the buffer as GL_PIXEL_UNPACK_BUFFER, pixel pointers are offsets into it until endUpload()
+    void beginUpload(int index);
+    //GL thread, unbinds the buffer and fences the upload
+    void endUpload(int index);
+    //GL thread, returns buffers the GPU is done with to the pool
+    void recycle();
+
+    inline unsigned int getBufferSize() const {return m_BufferSize;}
+    inline bool isPersistent() const {return m_Persistent;}
+};
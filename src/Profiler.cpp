@@ -0,0 +1,235 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <GL/glew.h>
+
+typedef std::chrono::steady_clock Clock;
+
+//a scope whose queries haven't been read yet
+struct PendingScope{
+    Profiler::Event event;
+    unsigned int query;         //begin timestamp, the end is the next query, None without GPU time
+    bool ended;
+};
+
+struct FrameSet{
+    std::vector<PendingScope> scopes;
+    std::vector<unsigned int> queries;     //grows on demand, two per scope
+    unsigned int usedQueries;
+    unsigned int lastQuery;     //the end query issued last, None before the first
+    unsigned int generation;    //counts resolves, a scope index from before one is stale
+};
+
+//a scope index is the scope in its set, the set and the set's generation
+static const unsigned int IndexBits = 22;
+static const unsigned int SetBits = 2;
+static const unsigned int MaxScopesPerSet = 1u << IndexBits;
+static_assert(Profiler::FrameSets <= (1u << SetBits), "FrameSets doesn't fit into a scope index");
+
+bool Profiler::s_Enabled = false;
+
+static FrameSet s_Sets[Profiler::FrameSets];
+static unsigned int s_Set = 0;
+static unsigned int s_Frame = 0;
+static unsigned int s_Depth = 0;
+static Clock::time_point s_Epoch;
+static int64_t s_GpuOffset = 0;        //CPU ns = GPU ns + offset
+
+static std::vector<Profiler::Event> s_Ring(65536);
+static unsigned int s_RingHead = 0;     //next slot to write
+static unsigned int s_RingCount = 0;
+
+static uint64_t now(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now()-s_Epoch).count();
+}
+
+static void push(const Profiler::Event& event){
+    s_Ring[s_RingHead] = event;
+    s_RingHead = (s_RingHead+1) % s_Ring.size();
+    if(s_RingCount < s_Ring.size())
+        s_RingCount++;
+}
+
+//moves the scopes of a set into the ring, with GPU times if the queries are done or wait is set
+static void resolve(FrameSet& set, bool wait){
+    //timestamps complete in order, so the end query issued last tells for all of them
+    bool available = true;
+    if(set.lastQuery != Profiler::None && !wait){
+        GLint ready = 0;
+        glGetQueryObjectiv(set.queries[set.lastQuery], GL_QUERY_RESULT_AVAILABLE, &ready);
+        available = ready != 0;
+    }
+
+    for(unsigned int i=0; i<set.scopes.size(); i++){
+        PendingScope& scope = set.scopes[i];
+        //still open two frames later: keep the CPU time so far, its end query was never issued
+        if(!scope.ended)
+            scope.event.cpuDuration = now()-scope.event.cpuStart;
+        else if(available && scope.query != Profiler::None){
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(set.queries[scope.query], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(set.queries[scope.query+1], GL_QUERY_RESULT, &end);
+            scope.event.gpuStart = (uint64_t)((int64_t)begin+s_GpuOffset);
+            scope.event.gpuDuration = end > begin ? end-begin : 0;
+            scope.event.hasGpuTime = true;
+        }
+        push(scope.event);
+    }
+    set.scopes.clear();
+    set.usedQueries = 0;
+    set.lastQuery = Profiler::None;
+    set.generation++;
+}
+
+void Profiler::setEnabled(bool enabled){
+    if(enabled && !s_Enabled){
+        clear();
+        s_Epoch = Clock::now();
+        //maps GPU timestamps onto the CPU clock
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        s_GpuOffset = (int64_t)now()-gpuNow;
+    }
+    else if(!enabled && s_Enabled){
+        flush();
+    }
+    s_Enabled = enabled;
+}
+
+void Profiler::setCapacity(unsigned int capacity){
+    s_Ring.assign(std::max(capacity, 1u), Event());
+    s_RingHead = 0;
+    s_RingCount = 0;
+}
+
+void Profiler::beginFrame(){
+    if(!s_Enabled)
+        return;
+    s_Frame++;
+    s_Set = (s_Set+1) % FrameSets;
+    resolve(s_Sets[s_Set], false);
+}
+
+void Profiler::flush(){
+    //oldest set first, so the ring stays in order
+    for(unsigned int i=1; i<=FrameSets; i++)
+        resolve(s_Sets[(s_Set+i) % FrameSets], true);
+}
+
+unsigned int Profiler::beginScope(const char* name){
+    FrameSet& set = s_Sets[s_Set];
+    if(set.scopes.size() >= MaxScopesPerSet-1)     //the last index of the last generation would be None
+        return None;
+    PendingScope scope;
+    scope.event.name = name;
+    scope.event.frame = s_Frame;
+    scope.event.depth = s_Depth++;
+    scope.event.cpuDuration = 0;
+    scope.event.gpuStart = 0;
+    scope.event.gpuDuration = 0;
+    scope.event.hasGpuTime = false;
+    scope.query = None;
+    scope.ended = false;
+
+    if(set.scopes.size() < MaxScopesPerFrame){
+        if(set.usedQueries+2 > set.queries.size()){
+            unsigned int first = set.queries.size();
+            set.queries.resize(first+64);
+            glGenQueries(64, &set.queries[first]);
+        }
+        scope.query = set.usedQueries;
+        set.usedQueries += 2;
+        glQueryCounter(set.queries[scope.query], GL_TIMESTAMP);
+    }
+
+    scope.event.cpuStart = now();
+    set.scopes.push_back(scope);
+    return ((set.generation & 0xFF) << (IndexBits+SetBits)) | (s_Set << IndexBits) | (unsigned int)(set.scopes.size()-1);
+}
+
+void Profiler::endScope(unsigned int scopeIndex){
+    uint64_t end = now();
+    s_Depth--;
+    //a frame may have started inside the scope, the index names its set. If
+    //the set was resolved since, the scope was already written without its end.
+    FrameSet& set = s_Sets[(scopeIndex >> IndexBits) & ((1u << SetBits)-1)];
+    unsigned int index = scopeIndex & (MaxScopesPerSet-1);
+    if((scopeIndex >> (IndexBits+SetBits)) != (set.generation & 0xFF) || index >= set.scopes.size())
+        return;
+    PendingScope& scope = set.scopes[index];
+    scope.ended = true;
+    scope.event.cpuDuration = end-scope.event.cpuStart;
+    if(scope.query != None){
+        glQueryCounter(set.queries[scope.query+1], GL_TIMESTAMP);
+        set.lastQuery = scope.query+1;
+    }
+}
+
+std::vector<Profiler::Event> Profiler::getEvents(){
+    std::vector<Event> events;
+    events.reserve(s_RingCount);
+    unsigned int first = (s_RingHead+s_Ring.size()-s_RingCount) % s_Ring.size();
+    for(unsigned int i=0; i<s_RingCount; i++)
+        events.push_back(s_Ring[(first+i) % s_Ring.size()]);
+    return events;
+}
+
+void Profiler::clear(){
+    for(unsigned int i=0; i<FrameSets; i++){
+        s_Sets[i].scopes.clear();
+        s_Sets[i].usedQueries = 0;
+        s_Sets[i].lastQuery = None;
+        s_Sets[i].generation++;
+    }
+    s_RingHead = 0;
+    s_RingCount = 0;
+    s_Frame = 0;
+    s_Depth = 0;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path){
+    FILE* file = fopen(path.c_str(), "w");
+    if(!file)
+        return false;
+
+    fprintf(file, "{\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+    std::vector<Event> events = getEvents();
+    for(unsigned int i=0; i<events.size(); i++){
+        const Event& e = events[i];
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+            e.name, e.cpuStart/1000.0, e.cpuDuration/1000.0, e.frame);
+        if(e.hasGpuTime)
+            fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u}}",
+                e.name, e.gpuStart/1000.0, e.gpuDuration/1000.0, e.frame);
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
+
+void Profiler::printSummary(FILE* file){
+    struct Total{
+        unsigned int count;
+        uint64_t cpu, gpu;
+    };
+    std::vector<Event> events = getEvents();
+    if(events.empty())
+        return;
+
+    std::map<std::string, Total> totals;
+    for(unsigned int i=0; i<events.size(); i++){
+        Total& total = totals[events[i].name];
+        total.count++;
+        total.cpu += events[i].cpuDuration;
+        total.gpu += events[i].gpuDuration;
+    }
+    double frames = events.back().frame-events.front().frame+1;
+    fprintf(file, "%-24s %10s %12s %12s\n", "scope", "per frame", "cpu ms", "gpu ms");
+    for(std::map<std::string, Total>::const_iterator it=totals.begin(); it!=totals.end(); ++it){
+        fprintf(file, "%-24s %10.1f %12.3f %12.3f\n", it->first.c_str(), it->second.count/frames,
+            it->second.cpu/frames/1000000.0, it->second.gpu/frames/1000000.0);
+    }
+}
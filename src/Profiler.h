@@ -0,0 +1,74 @@
+#pragma once
+#include <stdint.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//Scoped CPU and GPU timings for the GL thread. A ProfileScope measures the
+//CPU time with std::chrono and brackets the GPU work with two GL_TIMESTAMP
+//queries (GL_TIME_ELAPSED can't be nested). The queries of a frame are read
+//when their set is reused two frames later, after checking that the GPU is
+//done with them, so reading never stalls; GPU times that still aren't ready
+//are dropped. Resolved scopes go into a ring of the last events, which can be
+//written as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+//Disabled by default, a disabled scope is one branch.
+class Profiler{
+public:
+    static const unsigned int None = 0xFFFFFFFF;
+    static const unsigned int FrameSets = 2;                //query sets in flight
+    static const unsigned int MaxScopesPerFrame = 8192;     //later scopes get no GPU time
+
+    struct Event{
+        const char* name;           //not copied, use string literals
+        unsigned int frame;
+        unsigned int depth;         //nesting level on the CPU
+        uint64_t cpuStart;          //ns since the profiler was enabled
+        uint64_t cpuDuration;
+        uint64_t gpuStart;          //ns on the same clock, valid if hasGpuTime
+        uint64_t gpuDuration;
+        bool hasGpuTime;
+    };
+
+private:
+    static bool s_Enabled;
+
+public:
+    //enabling resets the clocks and drops all events
+    static void setEnabled(bool enabled);
+    static inline bool isEnabled() {return s_Enabled;}
+    //number of events kept, default 65536
+    static void setCapacity(unsigned int capacity);
+
+    //call once per frame before any scope of the frame
+    static void beginFrame();
+    //waits for all outstanding queries, e.g. before writing the trace
+    static void flush();
+
+    //used by ProfileScope, returns None while disabled
+    static unsigned int beginScope(const char* name);
+    static void endScope(unsigned int scope);
+
+    //oldest first
+    static std::vector<Event> getEvents();
+    static void clear();
+
+    //CPU and GPU events on two tracks
+    static bool writeChromeTrace(const std::string& path);
+    //average CPU and GPU ms per frame of every scope name
+    static void printSummary(FILE* file=stdout);
+};
+
+class ProfileScope{
+private:
+    unsigned int m_Scope;
+
+public:
+    explicit ProfileScope(const char* name)
+        : m_Scope(Profiler::isEnabled() ? Profiler::beginScope(name) : Profiler::None) {}
+    ~ProfileScope(){
+        if(m_Scope != Profiler::None)
+            Profiler::endScope(m_Scope);
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
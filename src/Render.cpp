@@ -1,13 +1,90 @@
 #include "Render.h"
+#include "GLState.h"
+#include "texture.h"
+#include "Profiler.h"
+
+static Renderer::Stats s_Stats = {0, 0};
 
 void Renderer::draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const{
+    draw(va, ib, shader, ib.getCount());
+}
+
+//draws only the first indexCount indices of ib (used by partially filled batches),
+//baseVertex is added to every index (used for data in a StreamingBuffer)
+void Renderer::draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int indexCount, int baseVertex) const{
+    ProfileScope scope("Renderer::draw");
     shader.bind();
     va.bind();
-    ib.bind();    
+    ib.bind();
 
-    glDrawElements(GL_TRIANGLES, ib.getCount(), GL_UNSIGNED_INT, nullptr);
+    s_Stats.drawCalls++;
+    s_Stats.instances++;
+    if(baseVertex == 0)
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+    else
+        glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, baseVertex);
+}
+
+//draws instanceCount copies of va, per-instance data comes from buffers added with a divisor
+void Renderer::drawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const{
+    ProfileScope scope("Renderer::drawInstanced");
+    shader.bind();
+    va.bind();
+    ib.bind();
+
+    s_Stats.drawCalls++;
+    s_Stats.instances += instanceCount;
+    glDrawElementsInstanced(GL_TRIANGLES, ib.getCount(), GL_UNSIGNED_INT, nullptr, instanceCount);
 }
 
 void Renderer::clear() const{
+    ProfileScope scope("Renderer::clear");
     glClear(GL_COLOR_BUFFER_BIT);
-}
\ No newline at end of file
+}
+
+void Renderer::submit(const VertexArray& va, const IndexBuffer& ib, Shader& shader, const Texture* texture,
+    const glm::mat4& model, bool translucent, float depth){
+    DrawCommand command;
+    command.key = RenderQueue::makeKey(shader.getRendererID(), texture ? texture->getRendererID() : 0,
+        va.getRendererID(), translucent, depth);
+    command.va = &va;
+    command.ib = &ib;
+    command.shader = &shader;
+    command.texture = texture;
+    command.translucent = translucent;
+    command.model = model;
+    m_Queue.push(command);
+}
+
+void Renderer::flush(){
+    const std::vector<const DrawCommand*>& commands = m_Queue.sort();
+    Shader* shader = nullptr;
+    UniformHandle modelUniform = {-1};
+    for(unsigned int i=0; i<commands.size(); i++){
+        const DrawCommand& command = *commands[i];
+        GLState::setBlend(command.translucent);
+        //untextured commands get no texture, not the one of the command sorted before them
+        if(command.texture)
+            command.texture->bind(0);
+        else
+            GLState::bindTexture(0, GL_TEXTURE_2D, 0);
+        //commands are grouped by program, so the lookup only runs on a switch
+        if(command.shader != shader){
+            shader = command.shader;
+            modelUniform = shader->getUniformHandle("u_Model");
+        }
+        shader->bind();
+        shader->setUniformMat4f(modelUniform, command.model);
+        draw(*command.va, *command.ib, *command.shader);
+    }
+    m_Queue.clear();
+}
+
+const Renderer::Stats& Renderer::getStats(){
+    return s_Stats;
+}
+
+void Renderer::resetStats(){
+    s_Stats.drawCalls = 0;
+    s_Stats.instances = 0;
+}
@@ -5,12 +5,31 @@
 #include "VertexArray.h"
 #include "IndexBuffer.h"
 #include "Shader.h"
+#include "RenderQueue.h"
 
 class Renderer{
+public:
+    //counted over all renderers, e.g. the BatchRenderer's flushes are included
+    struct Stats{
+        unsigned int drawCalls;
+        unsigned int instances;     //1 per plain draw
+    };
+
 private:
+    RenderQueue m_Queue;
 
 public:
     void draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader) const;
+    void draw(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int indexCount, int baseVertex=0) const;
+    void drawInstanced(const VertexArray& va, const IndexBuffer& ib, const Shader& shader, unsigned int instanceCount) const;
     void clear() const;
 
+    //deferred drawing: commands are sorted by state and submitted in flush(),
+    //the shader gets model as u_Model and the camera from the Camera block
+    void submit(const VertexArray& va, const IndexBuffer& ib, Shader& shader, const Texture* texture,
+        const glm::mat4& model, bool translucent=false, float depth=0.0f);
+    void flush();
+
+    static const Stats& getStats();
+    static void resetStats();
 }; 
\ No newline at end of file
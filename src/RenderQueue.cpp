@@ -0,0 +1,92 @@
+#include "RenderQueue.h"
+
+static const uint64_t IdMask = 0xFFF;
+static const uint64_t DepthMask = 0xFFFFFF;
+
+static uint64_t quantizeDepth(float depth){
+    if(depth < 0.0f)
+        depth = 0.0f;
+    if(depth > 1.0f)
+        depth = 1.0f;
+    return (uint64_t)(depth*(float)DepthMask) & DepthMask;
+}
+
+uint64_t RenderQueue::makeKey(unsigned int program, unsigned int texture, unsigned int vertexArray, bool translucent, float depth){
+    uint64_t p = program & IdMask;
+    uint64_t t = texture & IdMask;
+    uint64_t v = vertexArray & IdMask;
+    uint64_t d = quantizeDepth(depth);
+
+    if(!translucent)
+        return (p << 51) | (t << 39) | (v << 27) | (d << 3);
+
+    //back to front, ties keep as few state changes as possible
+    return (1ull << 63) | ((DepthMask-d) << 39) | (p << 27) | (t << 15) | (v << 3);
+}
+
+void RenderQueue::push(const DrawCommand& command){
+    m_Commands.push_back(command);
+}
+
+void RenderQueue::clear(){
+    m_Commands.clear();
+    m_Sorted.clear();
+}
+
+//LSD radix sort over the 8 key bytes. All histograms are built in one pass and
+//bytes where every key falls into the same bucket are skipped.
+void RenderQueue::radixSort(){
+    const unsigned int count = m_Entries.size();
+    m_Scratch.resize(count);
+
+    unsigned int histograms[8][256] = {};
+    for(unsigned int i=0; i<count; i++){
+        uint64_t key = m_Entries[i].key;
+        for(int byte=0; byte<8; byte++)
+            histograms[byte][(key >> (byte*8)) & 0xFF]++;
+    }
+
+    SortEntry* src = &m_Entries[0];
+    SortEntry* dst = &m_Scratch[0];
+    for(int byte=0; byte<8; byte++){
+        unsigned int* histogram = histograms[byte];
+        unsigned int first = (m_Entries[0].key >> (byte*8)) & 0xFF;
+        if(histogram[first] == count)
+            continue;
+
+        unsigned int offset = 0;
+        for(int bucket=0; bucket<256; bucket++){
+            unsigned int bucketCount = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += bucketCount;
+        }
+        for(unsigned int i=0; i<count; i++){
+            unsigned int bucket = (src[i].key >> (byte*8)) & 0xFF;
+            dst[histogram[bucket]++] = src[i];
+        }
+        SortEntry* swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if(src != &m_Entries[0])
+        m_Entries.swap(m_Scratch);
+}
+
+const std::vector<const DrawCommand*>& RenderQueue::sort(){
+    m_Sorted.clear();
+    if(m_Commands.empty())
+        return m_Sorted;
+
+    m_Entries.resize(m_Commands.size());
+    for(unsigned int i=0; i<m_Commands.size(); i++){
+        m_Entries[i].key = m_Commands[i].key;
+        m_Entries[i].index = i;
+    }
+    radixSort();
+
+    m_Sorted.reserve(m_Entries.size());
+    for(unsigned int i=0; i<m_Entries.size(); i++)
+        m_Sorted.push_back(&m_Commands[m_Entries[i].index]);
+    return m_Sorted;
+}
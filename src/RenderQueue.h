@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "vendor/glm/glm/glm.hpp"
+
+class VertexArray;
+class IndexBuffer;
+class Shader;
+class Texture;
+
+//One deferred draw. The key decides the submission order, see makeKey().
+struct DrawCommand{
+    uint64_t key;
+    const VertexArray* va;
+    const IndexBuffer* ib;
+    Shader* shader;
+    const Texture* texture;     //bound to slot 0, nullptr unbinds slot 0
+    bool translucent;
+    glm::mat4 model;
+};
+
+//Collects draw commands during a frame and sorts them once before they are
+//submitted. Opaque draws come first, grouped by program, texture and vertex
+//array, then front to back. Translucent draws follow back to front.
+class RenderQueue{
+private:
+    struct SortEntry{
+        uint64_t key;
+        uint32_t index;
+    };
+
+    std::vector<DrawCommand> m_Commands;
+    std::vector<SortEntry> m_Entries;
+    std::vector<SortEntry> m_Scratch;
+    std::vector<const DrawCommand*> m_Sorted;
+
+    void radixSort();
+
+public:
+    //64 bit key, bit 63 is the blend mode, depth is expected in [0,1]
+    //  opaque:      program(12) texture(12) vertex array(12) depth(24)
+    //  translucent: inverted depth(24) program(12) texture(12) vertex array(12)
+    //GL names are truncated to 12 bits, collisions only cost a state change.
+    static uint64_t makeKey(unsigned int program, unsigned int texture, unsigned int vertexArray, bool translucent, float depth);
+
+    void push(const DrawCommand& command);
+
+    //returns the commands in submission order, valid until clear() or push()
+    const std::vector<const DrawCommand*>& sort();
+    void clear();
+
+    inline unsigned int size() const {return m_Commands.size();}
+    inline bool empty() const {return m_Commands.empty();}
+};
@@ -0,0 +1,55 @@
+#include "Sampler.h"
+#include "GLState.h"
+
+Sampler::Sampler(unsigned int minFilter, unsigned int magFilter, unsigned int wrap, float anisotropy)
+    : m_RendererID(0)
+{
+    glGenSamplers(1, &m_RendererID);
+    setFilter(minFilter, magFilter);
+    setWrap(wrap);
+    setAnisotropy(anisotropy);
+}
+
+Sampler::~Sampler(){
+    glDeleteSamplers(1, &m_RendererID);
+    GLState::samplerDeleted(m_RendererID);
+}
+
+void Sampler::setFilter(unsigned int minFilter, unsigned int magFilter){
+    glSamplerParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, minFilter);
+    glSamplerParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, magFilter);
+}
+
+void Sampler::setWrap(unsigned int wrap){
+    glSamplerParameteri(m_RendererID, GL_TEXTURE_WRAP_S, wrap);
+    glSamplerParameteri(m_RendererID, GL_TEXTURE_WRAP_T, wrap);
+}
+
+void Sampler::setAnisotropy(float anisotropy){
+    float maxAnisotropy = getMaxAnisotropy();
+    if(maxAnisotropy <= 1.0f)
+        return;
+    if(anisotropy > maxAnisotropy)
+        anisotropy = maxAnisotropy;
+    if(anisotropy < 1.0f)
+        anisotropy = 1.0f;
+    glSamplerParameterf(m_RendererID, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+}
+
+void Sampler::bind(unsigned int slot) const{
+    GLState::bindSampler(slot, m_RendererID);
+}
+
+void Sampler::unbind(unsigned int slot) const{
+    GLState::bindSampler(slot, 0);
+}
+
+float Sampler::getMaxAnisotropy(){
+    static float maxAnisotropy = 0.0f;
+    if(maxAnisotropy == 0.0f){
+        maxAnisotropy = 1.0f;
+        if(GLEW_ARB_texture_filter_anisotropic || GLEW_EXT_texture_filter_anisotropic)
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+    }
+    return maxAnisotropy;
+}
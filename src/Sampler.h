@@ -0,0 +1,29 @@
+#pragma once
+#include <GL/glew.h>
+
+//Filter and wrap settings as a GL sampler object. A sampler bound to a unit
+//overrides the parameters of whatever texture is bound there, so one sampler
+//can be shared by all textures that are drawn the same way.
+class Sampler{
+private:
+    unsigned int m_RendererID;
+
+public:
+    //trilinear by default, textures without mip levels are sampled bilinear
+    Sampler(unsigned int minFilter=GL_LINEAR_MIPMAP_LINEAR, unsigned int magFilter=GL_LINEAR,
+        unsigned int wrap=GL_CLAMP_TO_EDGE, float anisotropy=1.0f);
+    ~Sampler();
+
+    void setFilter(unsigned int minFilter, unsigned int magFilter);
+    void setWrap(unsigned int wrap);
+    //clamped to getMaxAnisotropy(), ignored without anisotropic filtering
+    void setAnisotropy(float anisotropy);
+
+    void bind(unsigned int slot=0) const;
+    void unbind(unsigned int slot=0) const;
+
+    inline unsigned int getRendererID() const {return m_RendererID;}
+
+    //1 if the driver has no anisotropic filtering
+    static float getMaxAnisotropy();
+};
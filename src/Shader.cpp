@@ -1,45 +1,138 @@
 #include <iostream>
-#include <fstream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 #include "Shader.h"
 #include "Render.h"
+#include "GLState.h"
+#include "UniformBuffer.h"
+#include "ShaderCache.h"
+#include "AssetPack.h"
+#include "TraceRecorder.h"
+
+//block name -> binding point, applied to every program after linking
+static std::unordered_map<std::string, unsigned int>& uniformBlockRegistry(){
+    static std::unordered_map<std::string, unsigned int> registry = {
+        {"Camera", CameraBinding},
+        {"TextureHandles", TextureHandlesBinding}
+    };
+    return registry;
+}
 
 
 Shader::Shader(const std::string& filepath)
-    : m_FilePath(filepath), m_RendererID(0)
+    : m_FilePath(filepath), m_RendererID(0), m_VertexShader(0), m_FragmentShader(0), m_CacheKey(0), m_Pending(false)
+{
+    ShaderProgramSource source = parseShader(filepath);
+    createShader(source.VertexSource, source.FragmentSource);
+    finishShader();
+};
+
+Shader::Shader(const std::string& filepath, Deferred)
+    : m_FilePath(filepath), m_RendererID(0), m_VertexShader(0), m_FragmentShader(0), m_CacheKey(0), m_Pending(false)
 {
     ShaderProgramSource source = parseShader(filepath);
-    m_RendererID = createShader(source.VertexSource, source.FragmentSource);
+    createShader(source.VertexSource, source.FragmentSource);
 };
 
 Shader::~Shader(){
+    if(m_VertexShader){
+        glDeleteShader(m_VertexShader);
+        glDeleteShader(m_FragmentShader);
+    }
     glDeleteProgram(m_RendererID);
+    GLState::programDeleted(m_RendererID);
 };
 
 void Shader::bind() const{
-    glUseProgram(m_RendererID);
+    GLState::useProgram(m_RendererID);
 };
 void Shader::unbind() const{
-    glUseProgram(0);
+    GLState::useProgram(0);
 };
 
-int Shader::getUniformLocation(const std::string& name)
+//linear search, programs have few uniforms and there is nothing to hash or allocate
+int Shader::findUniform(const char* name) const
 {
-    if(m_UniformLocationCache.find(name)!=m_UniformLocationCache.end())
-        return m_UniformLocationCache[name];
-    
-    int location = glGetUniformLocation(m_RendererID, name.c_str());
-    if(location==-1)
+    for(unsigned int i=0; i<m_Uniforms.size(); i++){
+        if(m_Uniforms[i].name == name)
+            return i;
+    }
+    return -1;
+};
+
+int Shader::getUniformLocation(const char* name)
+{
+    return getLocation(getUniformHandle(name));
+};
+
+UniformHandle Shader::getUniformHandle(const char* name)
+{
+    int index = findUniform(name);
+    if(index < 0){
+        //remember missing uniforms too, so the warning is only printed once
         std::cout << "Warning: Uniform '" << name << "' does not exist" << std::endl;
-    m_UniformLocationCache[name]=location;
-    return location;
+        index = m_Uniforms.size();
+        m_Uniforms.push_back({name, -1, 0, 0});
+    }
+    return {index};
+};
+
+void Shader::queryUniforms(){
+    m_Uniforms.clear();
+
+    int uniformCount = 0;
+    glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &uniformCount);
+    m_Uniforms.reserve(uniformCount);
+    for(int i=0; i<uniformCount; i++){
+        char name[128];
+        int length = 0;
+        int size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_RendererID, i, sizeof(name), &length, &size, &type, name);
+
+        //members of uniform blocks have no location
+        int location = glGetUniformLocation(m_RendererID, name);
+        if(location == -1)
+            continue;
+
+        std::string uniformName(name, length);
+        if(uniformName.size() > 3 && uniformName.compare(uniformName.size()-3, 3, "[0]") == 0)
+            uniformName.resize(uniformName.size()-3);
+        m_Uniforms.push_back({uniformName, location, type, size});
+    }
+};
+
+void Shader::bindUniformBlock(const std::string& blockName, unsigned int binding){
+    unsigned int index = glGetUniformBlockIndex(m_RendererID, blockName.c_str());
+    if(index == GL_INVALID_INDEX){
+        std::cout << "Warning: Uniform block '" << blockName << "' does not exist" << std::endl;
+        return;
+    }
+    glUniformBlockBinding(m_RendererID, index, binding);
+};
+
+void Shader::registerUniformBlock(const std::string& blockName, unsigned int binding){
+    uniformBlockRegistry()[blockName] = binding;
 };
 
+void Shader::bindUniformBlocks(){
+    int blockCount = 0;
+    glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+    for(int i=0; i<blockCount; i++){
+        char name[128];
+        glGetActiveUniformBlockName(m_RendererID, i, sizeof(name), nullptr, name);
+        auto it = uniformBlockRegistry().find(name);
+        if(it != uniformBlockRegistry().end())
+            glUniformBlockBinding(m_RendererID, i, it->second);
+    }
+};
 
 ShaderProgramSource Shader::parseShader(const std::string& filepath){
-    std::ifstream stream(filepath);
+    //from a mounted asset pack or the file system
+    AssetFile file(filepath);
+    std::istringstream stream(file.isOpen() ? std::string((const char*)file.getData(), file.getSize()) : std::string());
 
     enum class ShaderType{
         NONE=-1, VERTEX=0, FRAGMENT=1
@@ -66,33 +159,26 @@ ShaderProgramSource Shader::parseShader(const std::string& filepath){
     return {ss[0].str(), ss[1].str()};
 }
 
-unsigned int Shader::createShader(const std::string& vertexShader, const std::string& fragmentShader){
-    unsigned int program = glCreateProgram();
-    unsigned int vs = compileShader(GL_VERTEX_SHADER, vertexShader);
-    unsigned int fs = compileShader(GL_FRAGMENT_SHADER, fragmentShader);
+//Submits compile and link without asking for their status, so the driver can
+//work on several programs at once. finishShader() collects the results.
+void Shader::createShader(const std::string& vertexShader, const std::string& fragmentShader){
+    TraceScope trace("Shader::createShader", "shader");
+    m_Pending = true;
 
-    glAttachShader(program,vs);
-    glAttachShader(program,fs);
-    glLinkProgram(program);
-    glValidateProgram(program);
-
-    int result;
-    glGetProgramiv(program,GL_LINK_STATUS, &result);
-    if(result == GL_FALSE){
-        int length;
-        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
-        char* message = (char*)alloca(length * sizeof(char));
-        glGetProgramInfoLog(program,length,&length,message);
-        std::cout<<"Failed to link program!" << std::endl;
-        std::cout<<message<<std::endl;
-        glDeleteProgram(program);
-    }
+    //try the binary cache first, compiling is the slow part of startup
+    m_CacheKey = ShaderCache::makeKey(vertexShader, fragmentShader);
+    m_RendererID = ShaderCache::load(m_CacheKey);
+    if(m_RendererID)
+        return;
 
-    //Delete Shaders after succesful linking
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+    m_RendererID = glCreateProgram();
+    m_VertexShader = compileShader(GL_VERTEX_SHADER, vertexShader);
+    m_FragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShader);
 
-    return program;
+    glAttachShader(m_RendererID, m_VertexShader);
+    glAttachShader(m_RendererID, m_FragmentShader);
+    glProgramParameteri(m_RendererID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(m_RendererID);
 }
 
 unsigned int Shader::compileShader(unsigned int type, const std::string& source){
@@ -100,7 +186,10 @@ unsigned int Shader::compileShader(unsigned int type, const std::string& source)
     const char* src = source.c_str();
     glShaderSource(id, 1, &src, nullptr);
     glCompileShader(id);
+    return id;
+}
 
+bool Shader::checkCompileStatus(unsigned int id, unsigned int type){
     //Error handeling
     int result;
     glGetShaderiv(id,GL_COMPILE_STATUS, &result);
@@ -111,20 +200,78 @@ unsigned int Shader::compileShader(unsigned int type, const std::string& source)
         glGetShaderInfoLog(id,length,&length,message);
         std::cout<<"Failed to compile " << (type==GL_VERTEX_SHADER? "vertex" : "fragment") << " shader!" << std::endl;
         std::cout<<message<<std::endl;
-        glDeleteShader(id);
-        return 0;
+        return false;
     }
-    return id;
+    return true;
+}
+
+//true if finishShader() won't block, needs KHR_parallel_shader_compile to ask without waiting
+bool Shader::isLinkCompleted() const{
+    if(!m_Pending || !m_VertexShader)
+        return true;
+    if(!GLEW_KHR_parallel_shader_compile && !GLEW_ARB_parallel_shader_compile)
+        return true;
+
+    int completed;
+    glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &completed);
+    return completed == GL_TRUE;
 }
 
-void Shader::setUniform4f(const std::string& name, float v0, float v1, float v2, float v3){
+void Shader::finishShader(){
+    if(!m_Pending)
+        return;
+    TraceScope trace("Shader::finishShader", "shader");
+    m_Pending = false;
+
+    //programs from the binary cache are already linked
+    if(m_VertexShader){
+        int result;
+        glGetProgramiv(m_RendererID,GL_LINK_STATUS, &result);
+        if(result == GL_FALSE){
+            checkCompileStatus(m_VertexShader, GL_VERTEX_SHADER);
+            checkCompileStatus(m_FragmentShader, GL_FRAGMENT_SHADER);
+
+            int length;
+            glGetProgramiv(m_RendererID, GL_INFO_LOG_LENGTH, &length);
+            char* message = (char*)alloca(length * sizeof(char));
+            glGetProgramInfoLog(m_RendererID,length,&length,message);
+            std::cout<<"Failed to link program '" << m_FilePath << "'!" << std::endl;
+            std::cout<<message<<std::endl;
+            glDeleteProgram(m_RendererID);
+            m_RendererID = 0;
+        }
+        else{
+#ifndef NDEBUG
+            glValidateProgram(m_RendererID);
+#endif
+            ShaderCache::store(m_CacheKey, m_RendererID);
+        }
+
+        //Delete Shaders after linking, the program keeps what it needs
+        glDeleteShader(m_VertexShader);
+        glDeleteShader(m_FragmentShader);
+        m_VertexShader = 0;
+        m_FragmentShader = 0;
+    }
+
+    if(m_RendererID){
+        bindUniformBlocks();
+        queryUniforms();
+    }
+}
+
+void Shader::setUniform4f(const char* name, float v0, float v1, float v2, float v3){
     glUniform4f(getUniformLocation(name), v0,v1,v2,v3);
 };
 
-void Shader::setUniform1i(const std::string& name, int value){
+void Shader::setUniform1i(const char* name, int value){
     glUniform1i(getUniformLocation(name), value);
 };
 
-void Shader::setUniformMat4f(const std::string& name, const glm::mat4& matrix){
+void Shader::setUniform1iv(const char* name, int count, const int* values){
+    glUniform1iv(getUniformLocation(name), count, values);
+};
+
+void Shader::setUniformMat4f(const char* name, const glm::mat4& matrix){
     glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &matrix[0][0]);
 };
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
+#include <stdint.h>
 #include <string>
-#include <unordered_map>
+#include <vector>
+#include <GL/glew.h>
 #include "vendor/glm/glm/glm.hpp"
 
 struct ShaderProgramSource{
@@ -8,16 +10,50 @@ struct ShaderProgramSource{
     std::string FragmentSource;
 };
 
+//active uniform, filled in once after linking
+struct UniformInfo{
+    std::string name;       //arrays without the "[0]"
+    int location;
+    unsigned int type;
+    int size;               //array length
+};
+
+//index into a Shader's uniform table, resolve once with getUniformHandle()
+struct UniformHandle{
+    int index;
+};
+
 class Shader {
 private:
     std::string m_FilePath;
     unsigned int m_RendererID;
-    std::unordered_map<std::string, int> m_UniformLocationCache;
+    std::vector<UniformInfo> m_Uniforms;
+
+    //compile and link are only submitted in createShader(), finishShader() checks the results
+    unsigned int m_VertexShader;
+    unsigned int m_FragmentShader;
+    uint64_t m_CacheKey;
+    bool m_Pending;
+
+    struct Deferred{};
+    Shader(const std::string& filepath, Deferred);  //submits only, see ShaderLibrary
 
     ShaderProgramSource parseShader(const std::string& filepath);
-    int getUniformLocation(const std::string& name);
-    unsigned int createShader(const std::string& vertexShader, const std::string& fragmentShader);
+    int findUniform(const char* name) const;
+    int getUniformLocation(const char* name);
+    void queryUniforms();
+    void createShader(const std::string& vertexShader, const std::string& fragmentShader);
     unsigned int compileShader(unsigned int type, const std::string& source);
+    bool checkCompileStatus(unsigned int id, unsigned int type);
+    bool isLinkCompleted() const;
+    void finishShader();
+    void bindUniformBlocks();
+
+    inline int getLocation(UniformHandle handle) const {
+        return handle.index >= 0 ? m_Uniforms[handle.index].location : -1;
+    }
+
+    friend class ShaderLibrary;
 
 public:
     Shader(const std::string& filename);
@@ -26,8 +62,26 @@ public:
     void bind() const;
     void unbind() const;
 
-    //set uniforms
-    void setUniform4f(const std::string& name, float v0, float v1, float v2, float v3);
-    void setUniform1i(const std::string& name, int value);
-    void setUniformMat4f(const std::string& name, const glm::mat4& matrix);
+    inline unsigned int getRendererID() const {return m_RendererID;}
+
+    //uniform blocks, see UniformBuffer.h
+    void bindUniformBlock(const std::string& blockName, unsigned int binding);
+    //programs created afterwards bind blocks named blockName to binding
+    static void registerUniformBlock(const std::string& blockName, unsigned int binding);
+
+    //uniform handles, invalid handles are ignored by the setters
+    UniformHandle getUniformHandle(const char* name);
+    inline const std::vector<UniformInfo>& getUniforms() const {return m_Uniforms;}
+
+    //set uniforms by handle, no lookup at all
+    inline void setUniform4f(UniformHandle handle, float v0, float v1, float v2, float v3) {glUniform4f(getLocation(handle), v0,v1,v2,v3);}
+    inline void setUniform1i(UniformHandle handle, int value) {glUniform1i(getLocation(handle), value);}
+    inline void setUniform1iv(UniformHandle handle, int count, const int* values) {glUniform1iv(getLocation(handle), count, values);}
+    inline void setUniformMat4f(UniformHandle handle, const glm::mat4& matrix) {glUniformMatrix4fv(getLocation(handle), 1, GL_FALSE, &matrix[0][0]);}
+
+    //set uniforms by name
+    void setUniform4f(const char* name, float v0, float v1, float v2, float v3);
+    void setUniform1i(const char* name, int value);
+    void setUniform1iv(const char* name, int count, const int* values);
+    void setUniformMat4f(const char* name, const glm::mat4& matrix);
 };
\ No newline at end of file
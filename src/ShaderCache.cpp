@@ -0,0 +1,155 @@
+#include "ShaderCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <GL/glew.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+struct CacheHeader{
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+};
+
+static const char s_Magic[4] = {'G', 'L', 'P', 'B'};
+static const uint32_t CacheVersion = 1;
+
+static std::string s_Directory = ".shadercache";
+static bool s_Enabled = true;
+
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size){
+    const unsigned char* bytes = (const unsigned char*)data;
+    for(size_t i=0; i<size; i++){
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static uint64_t hashString(uint64_t hash, const char* str){
+    if(!str)
+        str = "";
+    return fnv1a(hash, str, strlen(str)+1);    //include the terminator as separator
+}
+
+static std::string entryPath(uint64_t key){
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)key);
+    return s_Directory+name;
+}
+
+static void makeDirectory(const std::string& path){
+#ifdef _WIN32
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+void ShaderCache::setDirectory(const std::string& directory){
+    s_Directory = directory;
+}
+
+void ShaderCache::setEnabled(bool enabled){
+    s_Enabled = enabled;
+}
+
+bool ShaderCache::isAvailable(){
+    if(!s_Enabled)
+        return false;
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+uint64_t ShaderCache::makeKey(const std::string& vertexSource, const std::string& fragmentSource){
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashString(hash, (const char*)glGetString(GL_VENDOR));
+    hash = hashString(hash, (const char*)glGetString(GL_RENDERER));
+    hash = hashString(hash, (const char*)glGetString(GL_VERSION));
+    hash = hashString(hash, vertexSource.c_str());
+    hash = hashString(hash, fragmentSource.c_str());
+    return hash;
+}
+
+unsigned int ShaderCache::load(uint64_t key){
+    if(!isAvailable())
+        return 0;
+
+    std::string path = entryPath(key);
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file)
+        return 0;
+
+    CacheHeader header;
+    std::vector<char> binary;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, s_Magic, sizeof(s_Magic)) == 0
+        && header.version == CacheVersion
+        && header.key == key
+        && header.length > 0;
+    if(valid){
+        binary.resize(header.length);
+        valid = fread(&binary[0], 1, header.length, file) == header.length;
+    }
+    fclose(file);
+
+    unsigned int program = 0;
+    if(valid){
+        program = glCreateProgram();
+        glProgramBinary(program, header.format, &binary[0], header.length);
+        int result;
+        glGetProgramiv(program, GL_LINK_STATUS, &result);
+        if(result == GL_FALSE){
+            glDeleteProgram(program);
+            program = 0;
+        }
+    }
+
+    //stale or broken entry, the caller compiles and stores a fresh one
+    if(!program)
+        remove(path.c_str());
+    return program;
+}
+
+void ShaderCache::store(uint64_t key, unsigned int program){
+    if(!isAvailable())
+        return;
+
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(length <= 0)
+        return;
+
+    CacheHeader header;
+    memcpy(header.magic, s_Magic, sizeof(s_Magic));
+    header.version = CacheVersion;
+    header.key = key;
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, &binary[0]);
+    header.format = format;
+    header.length = length;
+
+    makeDirectory(s_Directory);
+    //write to a temporary file first, so a crash never leaves half an entry
+    std::string path = entryPath(key);
+    std::string tempPath = path+".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if(!file)
+        return;
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1
+        && fwrite(&binary[0], 1, length, file) == (size_t)length;
+    fclose(file);
+
+    if(written)
+        written = rename(tempPath.c_str(), path.c_str()) == 0;
+    if(!written)
+        remove(tempPath.c_str());
+}
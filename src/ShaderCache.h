@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+//On-disk cache of linked program binaries (glGetProgramBinary). Entries are
+//keyed by a hash of the preprocessed sources and the GL vendor, renderer and
+//version strings, so a driver update never picks up an old binary. Entries the
+//driver rejects anyway are deleted and the caller recompiles.
+class ShaderCache{
+public:
+    static void setDirectory(const std::string& directory);    //default ".shadercache"
+    static void setEnabled(bool enabled);
+    static bool isAvailable();  //enabled and the driver offers binary formats
+
+    static uint64_t makeKey(const std::string& vertexSource, const std::string& fragmentSource);
+
+    //returns a linked program or 0 if there is no usable entry
+    static unsigned int load(uint64_t key);
+    static void store(uint64_t key, unsigned int program);
+};
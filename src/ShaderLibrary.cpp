@@ -0,0 +1,60 @@
+#include "ShaderLibrary.h"
+
+#include <iostream>
+#include <GL/glew.h>
+
+ShaderLibrary::ShaderLibrary(){
+    //let the driver use as many compiler threads as it wants
+    if(GLEW_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    else if(GLEW_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+}
+
+void ShaderLibrary::load(const std::string& name, const std::string& filepath){
+    if(exists(name)){
+        std::cout << "Warning: Shader '" << name << "' is already loaded" << std::endl;
+        return;
+    }
+    Shader* shader = new Shader(filepath, Shader::Deferred());
+    m_Shaders[name] = std::unique_ptr<Shader>(shader);
+    m_Pending.push_back(shader);
+}
+
+bool ShaderLibrary::poll(){
+    for(unsigned int i=0; i<m_Pending.size(); ){
+        if(m_Pending[i]->isLinkCompleted()){
+            m_Pending[i]->finishShader();
+            m_Pending[i] = m_Pending.back();
+            m_Pending.pop_back();
+        }
+        else{
+            i++;
+        }
+    }
+    return m_Pending.empty();
+}
+
+void ShaderLibrary::waitAll(){
+    for(unsigned int i=0; i<m_Pending.size(); i++)
+        m_Pending[i]->finishShader();
+    m_Pending.clear();
+}
+
+Shader& ShaderLibrary::get(const std::string& name){
+    Shader& shader = *m_Shaders.at(name);
+    if(shader.m_Pending){
+        shader.finishShader();
+        for(unsigned int i=0; i<m_Pending.size(); i++){
+            if(m_Pending[i] == &shader){
+                m_Pending.erase(m_Pending.begin()+i);
+                break;
+            }
+        }
+    }
+    return shader;
+}
+
+bool ShaderLibrary::exists(const std::string& name) const{
+    return m_Shaders.find(name) != m_Shaders.end();
+}
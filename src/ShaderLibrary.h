@@ -0,0 +1,33 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Shader.h"
+
+//Creates many programs at once: every compile and link is submitted before
+//any status is queried, so drivers with KHR_parallel_shader_compile spread
+//them over their compiler threads instead of compiling one after another.
+class ShaderLibrary{
+private:
+    std::unordered_map<std::string, std::unique_ptr<Shader>> m_Shaders;
+    std::vector<Shader*> m_Pending;
+
+public:
+    ShaderLibrary();
+
+    //submits the program, it is ready once poll() returns true or get() is called
+    void load(const std::string& name, const std::string& filepath);
+
+    //finishes all programs the driver is done with, true if nothing is pending
+    bool poll();
+    //finishes all programs, blocking
+    void waitAll();
+
+    //finishes the program first if it is still pending
+    Shader& get(const std::string& name);
+    bool exists(const std::string& name) const;
+
+    inline unsigned int getPendingCount() const {return m_Pending.size();}
+};
@@ -0,0 +1,82 @@
+#include "SkylinePacker.h"
+
+SkylinePacker::SkylinePacker(int width, int height)
+    : m_Width(width), m_Height(height)
+{
+    clear();
+}
+
+void SkylinePacker::clear(){
+    m_Skyline.clear();
+    m_Skyline.push_back({0, 0, m_Width});
+}
+
+int SkylinePacker::fit(unsigned int index, int width, int height) const{
+    int x = m_Skyline[index].x;
+    if(x+width > m_Width)
+        return -1;
+
+    int y = 0;
+    int remaining = width;
+    for(unsigned int i=index; remaining > 0; i++){
+        if(m_Skyline[i].y > y)
+            y = m_Skyline[i].y;
+        if(y+height > m_Height)
+            return -1;
+        remaining -= m_Skyline[i].width;
+    }
+    return y;
+}
+
+bool SkylinePacker::insert(int width, int height, int& x, int& y){
+    int bestIndex = -1;
+    int bestTop = m_Height+1;
+    int bestWidth = m_Width+1;
+    for(unsigned int i=0; i<m_Skyline.size(); i++){
+        int top = fit(i, width, height);
+        if(top < 0)
+            continue;
+        //lowest top edge first, then the narrowest segment to keep gaps small
+        if(top+height < bestTop || (top+height == bestTop && m_Skyline[i].width < bestWidth)){
+            bestIndex = i;
+            bestTop = top+height;
+            bestWidth = m_Skyline[i].width;
+            x = m_Skyline[i].x;
+            y = top;
+        }
+    }
+    if(bestIndex < 0)
+        return false;
+
+    addLevel(bestIndex, x, y, width, height);
+    return true;
+}
+
+void SkylinePacker::addLevel(unsigned int index, int x, int y, int width, int height){
+    m_Skyline.insert(m_Skyline.begin()+index, {x, y+height, width});
+
+    //cut the segments the new one covers
+    for(unsigned int i=index+1; i<m_Skyline.size(); ){
+        Segment& previous = m_Skyline[i-1];
+        Segment& segment = m_Skyline[i];
+        int shrink = previous.x+previous.width - segment.x;
+        if(shrink <= 0)
+            break;
+        segment.x += shrink;
+        segment.width -= shrink;
+        if(segment.width > 0)
+            break;
+        m_Skyline.erase(m_Skyline.begin()+i);
+    }
+
+    //merge neighbours at the same height
+    for(unsigned int i=1; i<m_Skyline.size(); ){
+        if(m_Skyline[i-1].y == m_Skyline[i].y){
+            m_Skyline[i-1].width += m_Skyline[i].width;
+            m_Skyline.erase(m_Skyline.begin()+i);
+        }
+        else{
+            i++;
+        }
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+
+//Packs rectangles into a fixed size area. The free space is kept as a
+//skyline, a list of horizontal segments, and every rectangle is placed
+//where its top edge ends up lowest (bottom-left rule).
+class SkylinePacker{
+private:
+    struct Segment{
+        int x, y, width;
+    };
+
+    int m_Width, m_Height;
+    std::vector<Segment> m_Skyline;
+
+    //y a rectangle would rest at if its left edge is at segment index, -1 if it doesn't fit
+    int fit(unsigned int index, int width, int height) const;
+    void addLevel(unsigned int index, int x, int y, int width, int height);
+
+public:
+    SkylinePacker(int width, int height);
+
+    //false if there is no room left
+    bool insert(int width, int height, int& x, int& y);
+    void clear();
+
+    inline int getWidth() const {return m_Width;}
+    inline int getHeight() const {return m_Height;}
+};
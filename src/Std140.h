@@ -0,0 +1,63 @@
+#pragma once
+#include <cstring>
+#include <vector>
+#include "vendor/glm/glm/glm.hpp"
+
+//alignment and size of a type inside a std140 uniform block
+template<typename T>
+struct Std140Layout{
+    static_assert(sizeof(T) == 0, "Type not implemented!");
+};
+
+template<> struct Std140Layout<float>        { static const unsigned int alignment = 4;  static const unsigned int size = 4;  };
+template<> struct Std140Layout<int>          { static const unsigned int alignment = 4;  static const unsigned int size = 4;  };
+template<> struct Std140Layout<unsigned int> { static const unsigned int alignment = 4;  static const unsigned int size = 4;  };
+template<> struct Std140Layout<glm::vec2>    { static const unsigned int alignment = 8;  static const unsigned int size = 8;  };
+template<> struct Std140Layout<glm::uvec2>   { static const unsigned int alignment = 8;  static const unsigned int size = 8;  };
+template<> struct Std140Layout<glm::vec3>    { static const unsigned int alignment = 16; static const unsigned int size = 12; };
+template<> struct Std140Layout<glm::vec4>    { static const unsigned int alignment = 16; static const unsigned int size = 16; };
+template<> struct Std140Layout<glm::uvec4>   { static const unsigned int alignment = 16; static const unsigned int size = 16; };
+template<> struct Std140Layout<glm::mat4>    { static const unsigned int alignment = 16; static const unsigned int size = 64; };
+
+//Packs values in std140 order into a byte buffer that can be uploaded to a
+//UniformBuffer as is. push() calls have to follow the member order of the block.
+//clear() keeps the memory, so a block can be repacked every frame.
+class Std140Buffer{
+private:
+    std::vector<unsigned char> m_Data;      //always a multiple of 16 bytes, the padding is zero
+    unsigned int m_End;                     //end of the last value
+
+    //reserves size bytes at the next offset with the given alignment
+    unsigned int allocate(unsigned int alignment, unsigned int size){
+        unsigned int offset = (m_End+alignment-1)/alignment*alignment;
+        m_End = offset+size;
+        m_Data.resize((m_End+15)/16*16, 0);
+        return offset;
+    }
+
+public:
+    Std140Buffer() : m_End(0) {}
+
+    //returns the offset of the value inside the block
+    template<typename T>
+    unsigned int push(const T& value){
+        unsigned int offset = allocate(Std140Layout<T>::alignment, Std140Layout<T>::size);
+        memcpy(&m_Data[offset], &value, Std140Layout<T>::size);
+        return offset;
+    }
+
+    //array elements are padded to a multiple of 16 bytes
+    template<typename T>
+    unsigned int pushArray(const T* values, unsigned int count){
+        const unsigned int stride = (Std140Layout<T>::size+15)/16*16;
+        unsigned int offset = allocate(16, count*stride);
+        for(unsigned int i=0; i<count; i++)
+            memcpy(&m_Data[offset+i*stride], &values[i], Std140Layout<T>::size);
+        return offset;
+    }
+
+    inline void clear() {m_Data.clear(); m_End = 0;}
+    inline const void* getData() const {return m_Data.empty() ? nullptr : &m_Data[0];}
+    //blocks are rounded up to a vec4, like GL_UNIFORM_BLOCK_DATA_SIZE
+    inline unsigned int getSize() const {return m_Data.size();}
+};
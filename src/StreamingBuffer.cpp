@@ -0,0 +1,118 @@
+#include "StreamingBuffer.h"
+#include "GLState.h"
+
+static unsigned int alignUp(unsigned int value, unsigned int alignment){
+    return (value+alignment-1)/alignment*alignment;
+}
+
+StreamingBuffer::StreamingBuffer(unsigned int target, unsigned int segmentSize, unsigned int alignment, bool allowPersistent)
+    : m_RendererID(0), m_Target(target), m_Alignment(alignment), m_SegmentSize(alignUp(segmentSize, alignment)),
+      m_Segment(0), m_Offset(0), m_MapOffset(0), m_MapSize(0),
+      m_Persistent(allowPersistent && GLEW_ARB_buffer_storage), m_MappedData(nullptr)
+{
+    for(unsigned int i=0; i<SegmentCount; i++)
+        m_Fences[i] = nullptr;
+
+    unsigned int size = m_SegmentSize*SegmentCount;
+    glGenBuffers(1, &m_RendererID);
+    GLState::bindBuffer(m_Target, m_RendererID);
+
+    if(m_Persistent){
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(m_Target, size, nullptr, flags);
+        m_MappedData = (unsigned char*)glMapBufferRange(m_Target, 0, size, flags);
+        if(!m_MappedData){
+            //immutable storage can't fall back in place, start over with a mutable buffer
+            glDeleteBuffers(1, &m_RendererID);
+            GLState::bufferDeleted(m_RendererID);
+            glGenBuffers(1, &m_RendererID);
+            GLState::bindBuffer(m_Target, m_RendererID);
+            m_Persistent = false;
+        }
+    }
+    if(!m_Persistent)
+        glBufferData(m_Target, size, nullptr, GL_STREAM_DRAW);
+}
+
+StreamingBuffer::~StreamingBuffer(){
+    for(unsigned int i=0; i<SegmentCount; i++){
+        if(m_Fences[i])
+            glDeleteSync(m_Fences[i]);
+    }
+    if(m_Persistent){
+        GLState::bindBuffer(m_Target, m_RendererID);
+        glUnmapBuffer(m_Target);
+    }
+    glDeleteBuffers(1, &m_RendererID);
+    GLState::bufferDeleted(m_RendererID);
+}
+
+void StreamingBuffer::waitForSegment(unsigned int segment){
+    GLsync fence = m_Fences[segment];
+    if(!fence)
+        return;
+
+    if(!m_Persistent && glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED){
+        //the GPU is behind: orphan the storage instead of stalling, all old fences become meaningless
+        GLState::bindBuffer(m_Target, m_RendererID);
+        glBufferData(m_Target, m_SegmentSize*SegmentCount, nullptr, GL_STREAM_DRAW);
+        for(unsigned int i=0; i<SegmentCount; i++){
+            if(m_Fences[i])
+                glDeleteSync(m_Fences[i]);
+            m_Fences[i] = nullptr;
+        }
+        return;
+    }
+
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while(result == GL_TIMEOUT_EXPIRED)
+        result = glClientWaitSync(fence, 0, 1000000);   //1 ms
+    glDeleteSync(fence);
+    m_Fences[segment] = nullptr;
+}
+
+void* StreamingBuffer::map(unsigned int size){
+    if(size > m_SegmentSize)
+        return nullptr;
+
+    unsigned int offset = alignUp(m_Offset, m_Alignment);
+    if(offset+size > (m_Segment+1)*m_SegmentSize){
+        //everything written into this segment has been drawn from, fence it and move on
+        m_Fences[m_Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_Segment = (m_Segment+1)%SegmentCount;
+        offset = m_Segment*m_SegmentSize;
+        waitForSegment(m_Segment);
+    }
+    m_MapOffset = offset;
+    m_MapSize = size;
+
+    if(m_Persistent)
+        return m_MappedData+offset;
+
+    GLState::bindBuffer(m_Target, m_RendererID);
+    return glMapBufferRange(m_Target, offset, size,
+        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+}
+
+unsigned int StreamingBuffer::commit(unsigned int usedSize){
+    if(usedSize > m_MapSize)
+        usedSize = m_MapSize;
+
+    if(!m_Persistent){
+        GLState::bindBuffer(m_Target, m_RendererID);
+        if(usedSize > 0)
+            glFlushMappedBufferRange(m_Target, 0, usedSize);
+        glUnmapBuffer(m_Target);
+    }
+    m_Offset = m_MapOffset+usedSize;
+    m_MapSize = 0;
+    return m_MapOffset;
+}
+
+void StreamingBuffer::bind() const{
+    GLState::bindBuffer(m_Target, m_RendererID);
+}
+
+void StreamingBuffer::unbind() const{
+    GLState::bindBuffer(m_Target, 0);
+}
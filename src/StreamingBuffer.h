@@ -0,0 +1,46 @@
+#pragma once
+#include <GL/glew.h>
+
+//Ring buffer for data that is rewritten every frame. The buffer is split into
+//SegmentCount segments, each guarded by a fence once the write head leaves it,
+//so the CPU never writes into memory the GPU still reads.
+//With ARB_buffer_storage the whole buffer stays persistently and coherently
+//mapped and map() just returns a pointer. Otherwise every map() is an
+//unsynchronized glMapBufferRange, and a segment that is still busy gets
+//orphaned instead of waited for.
+class StreamingBuffer{
+public:
+    static const unsigned int SegmentCount = 3;
+
+private:
+    unsigned int m_RendererID;
+    unsigned int m_Target;
+    unsigned int m_Alignment;
+    unsigned int m_SegmentSize;
+    unsigned int m_Segment;         //segment the write head is in
+    unsigned int m_Offset;          //write head, bytes from the start of the buffer
+    unsigned int m_MapOffset;
+    unsigned int m_MapSize;
+    bool m_Persistent;
+    unsigned char* m_MappedData;     //whole buffer, only in persistent mode
+    GLsync m_Fences[SegmentCount];
+
+    void waitForSegment(unsigned int segment);
+
+public:
+    //offsets returned by commit() are multiples of alignment (e.g. the vertex stride)
+    StreamingBuffer(unsigned int target, unsigned int segmentSize, unsigned int alignment=16, bool allowPersistent=true);
+    ~StreamingBuffer();
+
+    //returns a write pointer for up to size bytes or nullptr if size is larger than a segment
+    void* map(unsigned int size);
+    //ends the write started by map(), returns the byte offset of the written data
+    unsigned int commit(unsigned int usedSize);
+
+    void bind() const;
+    void unbind() const;
+
+    inline unsigned int getRendererID() const {return m_RendererID;}
+    inline unsigned int getSegmentSize() const {return m_SegmentSize;}
+    inline bool isPersistent() const {return m_Persistent;}
+};
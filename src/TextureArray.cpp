@@ -0,0 +1,71 @@
+#include "TextureArray.h"
+
+#include <algorithm>
+#include <iostream>
+#include <GL/glew.h>
+
+#include "stb_image.h"
+#include "GLState.h"
+#include "Mipmap.h"
+#include "ImageCache.h"
+
+TextureArray::TextureArray(int width, int height, int layerCount, int levelCount)
+    : m_RendererID(0), m_Width(width), m_Height(height), m_LayerCount(layerCount),
+      m_LevelCount(levelCount > 0 ? levelCount : getMipLevelCount(width, height))
+{
+    glGenTextures(1, &m_RendererID);
+    GLState::bindTexture(0, GL_TEXTURE_2D_ARRAY, m_RendererID);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, m_LevelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_LevelCount-1);
+
+    int levelWidth = width, levelHeight = height;
+    for(int level=0; level<m_LevelCount; level++){
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, levelWidth, levelHeight, layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        levelWidth = std::max(levelWidth/2, 1);
+        levelHeight = std::max(levelHeight/2, 1);
+    }
+}
+
+TextureArray::~TextureArray(){
+    glDeleteTextures(1, &m_RendererID);
+    GLState::textureDeleted(m_RendererID);
+}
+
+void TextureArray::setLayer(int layer, const void* pixels, int level){
+    int width = std::max(m_Width >> level, 1);
+    int height = std::max(m_Height >> level, 1);
+    GLState::bindTexture(0, GL_TEXTURE_2D_ARRAY, m_RendererID);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+}
+
+bool TextureArray::loadLayer(int layer, const std::string& path){
+    std::shared_ptr<const DecodedImage> image = ImageCache::load(path);
+    if(!image){
+        std::cout << "Failed to load '" << path << "': " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+    if(image->width != m_Width || image->height != m_Height){
+        std::cout << "'" << path << "' is " << image->width << "x" << image->height << ", the array layers are "
+            << m_Width << "x" << m_Height << std::endl;
+        return false;
+    }
+    setLayer(layer, image->pixels);
+    return true;
+}
+
+void TextureArray::generateMipmaps(){
+    GLState::bindTexture(0, GL_TEXTURE_2D_ARRAY, m_RendererID);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+}
+
+void TextureArray::bind(unsigned int slot) const{
+    GLState::bindTexture(slot, GL_TEXTURE_2D_ARRAY, m_RendererID);
+}
+
+void TextureArray::unbind(unsigned int slot) const{
+    GLState::bindTexture(slot, GL_TEXTURE_2D_ARRAY, 0);
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+
+//GL_TEXTURE_2D_ARRAY of RGBA8 layers that all have the same size. One
+//binding gives a shader every layer, so draws with different images can be
+//batched without running out of texture units.
+class TextureArray{
+private:
+    unsigned int m_RendererID;
+    int m_Width, m_Height;
+    int m_LayerCount;
+    int m_LevelCount;
+
+public:
+    //levelCount 0 allocates a full mip chain
+    TextureArray(int width, int height, int layerCount, int levelCount=1);
+    ~TextureArray();
+
+    //RGBA8 pixels of one layer, an offset if a GL_PIXEL_UNPACK_BUFFER is bound
+    void setLayer(int layer, const void* pixels, int level=0);
+    //decodes the image into a layer, false if it can't be loaded or has a different size
+    bool loadLayer(int layer, const std::string& path);
+    //builds all levels of all layers from the first one
+    void generateMipmaps();
+
+    void bind(unsigned int slot=0) const;
+    void unbind(unsigned int slot=0) const;
+
+    inline int getWidth() const {return m_Width;}
+    inline int getHeight() const {return m_Height;}
+    inline int getLayerCount() const {return m_LayerCount;}
+    inline int getLevelCount() const {return m_LevelCount;}
+    inline unsigned int getRendererID() const {return m_RendererID;}
+};
@@ -0,0 +1,92 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "stb_image.h"
+#include "ImageCache.h"
+
+TextureAtlas::TextureAtlas(int pageSize, int padding)
+    : m_PageSize(pageSize), m_Padding(padding)
+{
+}
+
+TextureAtlas::Page& TextureAtlas::addPage(){
+    Page* page = new Page{SkylinePacker(m_PageSize, m_PageSize),
+        std::vector<unsigned char>(m_PageSize*m_PageSize*4, 0),
+        std::unique_ptr<Texture>(new Texture(m_PageSize, m_PageSize, nullptr)), true};
+    m_Pages.push_back(std::unique_ptr<Page>(page));
+    return *page;
+}
+
+const AtlasRegion* TextureAtlas::add(const std::string& path){
+    std::shared_ptr<const DecodedImage> image = ImageCache::load(path);
+    if(!image){
+        std::cout << "Failed to load '" << path << "': " << stbi_failure_reason() << std::endl;
+        return nullptr;
+    }
+    const AtlasRegion* region = add(image->width, image->height, image->pixels);
+    if(!region)
+        std::cout << "'" << path << "' does not fit into an atlas page" << std::endl;
+    return region;
+}
+
+const AtlasRegion* TextureAtlas::add(int width, int height, const unsigned char* pixels){
+    int slotWidth = width+2*m_Padding;
+    int slotHeight = height+2*m_Padding;
+    if(slotWidth > m_PageSize || slotHeight > m_PageSize)
+        return nullptr;
+
+    //try the existing pages first, newer ones are emptier
+    Page* page = nullptr;
+    int x = 0, y = 0;
+    for(int i=m_Pages.size()-1; i>=0 && !page; i--){
+        if(m_Pages[i]->packer.insert(slotWidth, slotHeight, x, y))
+            page = m_Pages[i].get();
+    }
+    if(!page){
+        page = &addPage();
+        page->packer.insert(slotWidth, slotHeight, x, y);
+    }
+
+    x += m_Padding;
+    y += m_Padding;
+    blit(*page, x, y, width, height, pixels);
+    page->dirty = true;
+
+    const float size = (float)m_PageSize;
+    AtlasRegion region;
+    region.texture = page->texture.get();
+    region.uvMin = glm::vec2(x/size, y/size);
+    region.uvMax = glm::vec2((x+width)/size, (y+height)/size);
+    region.width = width;
+    region.height = height;
+    m_Regions.push_back(region);
+    return &m_Regions.back();
+}
+
+//copies the image and repeats its edge pixels into the padding around it
+void TextureAtlas::blit(Page& page, int x, int y, int width, int height, const unsigned char* pixels){
+    for(int row=-m_Padding; row<height+m_Padding; row++){
+        int srcRow = std::min(std::max(row, 0), height-1);
+        unsigned char* dst = &page.pixels[((y+row)*m_PageSize + x)*4];
+        const unsigned char* src = pixels + srcRow*width*4;
+        memcpy(dst, src, width*4);
+        for(int i=1; i<=m_Padding; i++){
+            memcpy(dst - i*4, src, 4);
+            memcpy(dst + (width-1+i)*4, src + (width-1)*4, 4);
+        }
+    }
+}
+
+void TextureAtlas::build(){
+    for(unsigned int i=0; i<m_Pages.size(); i++){
+        Page& page = *m_Pages[i];
+        if(!page.dirty)
+            continue;
+        page.texture->setData(m_PageSize, m_PageSize, &page.pixels[0]);
+        page.texture->generateMipmaps();
+        page.dirty = false;
+    }
+}
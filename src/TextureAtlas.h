@@ -0,0 +1,53 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "texture.h"
+#include "SkylinePacker.h"
+#include "vendor/glm/glm/glm.hpp"
+
+//part of an atlas page, uvs are ready to be used for a quad
+struct AtlasRegion{
+    const Texture* texture;     //the page
+    glm::vec2 uvMin;
+    glm::vec2 uvMax;
+    int width, height;          //in pixels
+};
+
+//Packs many small images into a few large pages so they can be drawn with
+//one texture binding. Images are packed on the CPU as they are added and the
+//changed pages are uploaded by build(). Every image gets a border of copies of
+//its edge pixels so filtering and the smaller mip levels don't bleed.
+class TextureAtlas{
+private:
+    struct Page{
+        SkylinePacker packer;
+        std::vector<unsigned char> pixels;
+        std::unique_ptr<Texture> texture;
+        bool dirty;
+    };
+
+    int m_PageSize;
+    int m_Padding;
+    std::vector<std::unique_ptr<Page>> m_Pages;
+    std::deque<AtlasRegion> m_Regions;      //deque, regions handed out must not move
+
+    Page& addPage();
+    void blit(Page& page, int x, int y, int width, int height, const unsigned char* pixels);
+
+public:
+    TextureAtlas(int pageSize=2048, int padding=2);
+
+    //decodes the image with stb_image, nullptr if it can't be loaded or is larger than a page
+    const AtlasRegion* add(const std::string& path);
+    //RGBA8 pixels, bottom row first like everything uploaded to GL
+    const AtlasRegion* add(int width, int height, const unsigned char* pixels);
+
+    //uploads all pages that changed since the last call and rebuilds their mipmaps
+    void build();
+
+    inline unsigned int getPageCount() const {return m_Pages.size();}
+    inline unsigned int getRegionCount() const {return m_Regions.size();}
+};
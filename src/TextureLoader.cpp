@@ -0,0 +1,173 @@
+#include "TextureLoader.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "stb_image.h"
+#include "Mipmap.h"
+#include "ImageCache.h"
+#include "TraceRecorder.h"
+
+//shown until the real image is uploaded
+static const unsigned char PlaceholderPixel[4] = {128, 128, 128, 255};
+
+TextureLoader::TextureLoader(unsigned int threadCount)
+    : m_Pending(0), m_Stop(false)
+{
+    if(threadCount == 0){
+        unsigned int cores = std::thread::hardware_concurrency();
+        threadCount = cores > 1 ? cores-1 : 1;
+    }
+    for(unsigned int i=0; i<threadCount; i++)
+        m_Workers.push_back(std::thread(&TextureLoader::workerMain, this));
+}
+
+TextureLoader::~TextureLoader(){
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_RequestCondition.notify_all();
+    for(unsigned int i=0; i<m_Workers.size(); i++)
+        m_Workers[i].join();
+
+    for(unsigned int i=0; i<m_Decoded.size(); i++){
+        delete m_Decoded[i].ktx;
+        delete[] m_Decoded[i].pixels;
+    }
+}
+
+TextureLoader::Decoded TextureLoader::decode(const Request& request){
+    TraceScope trace("TextureLoader decode", "texture");
+    Decoded decoded = {request.texture, nullptr, PixelBufferPool::None, nullptr, 0, 0};
+    if(KtxFile::isKtxPath(request.path)){
+        decoded.ktx = new KtxFile();
+        if(!decoded.ktx->load(request.path)){
+            delete decoded.ktx;
+            decoded.ktx = nullptr;
+        }
+        return decoded;
+    }
+
+    std::shared_ptr<const DecodedImage> image = ImageCache::load(request.path);
+    if(!image){
+        std::cout << "Failed to load texture '" << request.path << "': " << stbi_failure_reason() << std::endl;
+        return decoded;
+    }
+    decoded.width = image->width;
+    decoded.height = image->height;
+
+    std::vector<MipLevel> levels = getMipLevels(decoded.width, decoded.height);
+    unsigned int size = levels.back().offset + levels.back().size;
+    decoded.pixels = new unsigned char[size];
+    memcpy(decoded.pixels, image->pixels, levels[0].size);
+    generateMipChain(decoded.pixels, levels);
+
+    //large images or a busy pool fall back to uploading from client memory
+    decoded.pixelBuffer = m_PixelBuffers.acquire(size);
+    if(decoded.pixelBuffer != PixelBufferPool::None){
+        memcpy(m_PixelBuffers.getData(decoded.pixelBuffer), decoded.pixels, size);
+        delete[] decoded.pixels;
+        decoded.pixels = nullptr;
+    }
+    return decoded;
+}
+
+void TextureLoader::workerMain(){
+    TraceRecorder::setThreadName("TextureLoader");
+    while(true){
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_RequestCondition.wait(lock, [this]{return m_Stop || !m_Requests.empty();});
+            if(m_Stop)
+                return;
+            request = m_Requests.front();
+            m_Requests.pop_front();
+        }
+
+        Decoded decoded = decode(request);
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Decoded.push_back(decoded);
+        }
+        m_DecodedCondition.notify_one();
+    }
+}
+
+Texture& TextureLoader::load(const std::string& path){
+    auto it = m_Textures.find(path);
+    if(it != m_Textures.end())
+        return *it->second;
+
+    Texture* texture = new Texture(1, 1, PlaceholderPixel);
+    m_Textures[path] = std::unique_ptr<Texture>(texture);
+    m_Pending++;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Requests.push_back({texture, path});
+    }
+    m_RequestCondition.notify_one();
+    return *texture;
+}
+
+//the texture must already have all levels, chain is nullptr when the chain is in the bound pixel buffer
+static void uploadMipChain(Texture& texture, const unsigned char* chain){
+    std::vector<MipLevel> levels = getMipLevels(texture.getWidth(), texture.getHeight());
+    for(unsigned int i=0; i<levels.size(); i++)
+        texture.setSubData(0, 0, levels[i].width, levels[i].height, (const void*)((size_t)chain + levels[i].offset), i);
+}
+
+unsigned int TextureLoader::update(double budgetMs){
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+
+    m_PixelBuffers.recycle();
+    unsigned int uploaded = 0;
+    while(true){
+        Decoded decoded;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if(m_Decoded.empty())
+                break;
+            decoded = m_Decoded.front();
+            m_Decoded.pop_front();
+        }
+
+        //failed images keep the placeholder
+        if(decoded.ktx){
+            decoded.texture->setData(*decoded.ktx);
+            delete decoded.ktx;
+        }
+        else if(decoded.pixelBuffer != PixelBufferPool::None){
+            //storage is allocated before the buffer is bound, it would be read from otherwise
+            decoded.texture->resize(decoded.width, decoded.height, getMipLevelCount(decoded.width, decoded.height));
+            m_PixelBuffers.beginUpload(decoded.pixelBuffer);
+            uploadMipChain(*decoded.texture, nullptr);
+            m_PixelBuffers.endUpload(decoded.pixelBuffer);
+        }
+        else if(decoded.pixels){
+            decoded.texture->resize(decoded.width, decoded.height, getMipLevelCount(decoded.width, decoded.height));
+            uploadMipChain(*decoded.texture, decoded.pixels);
+            delete[] decoded.pixels;
+        }
+        m_Pending--;
+        uploaded++;
+
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+        if(elapsed.count() >= budgetMs)
+            break;
+    }
+    return uploaded;
+}
+
+void TextureLoader::waitAll(){
+    while(m_Pending > 0){
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_DecodedCondition.wait(lock, [this]{return !m_Decoded.empty();});
+        }
+        update(1e9);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "texture.h"
+#include "PixelBufferPool.h"
+#include "KtxFile.h"
+
+//Decodes images on a pool of worker threads. load() returns a texture right
+//away that shows a placeholder, update() uploads finished images on the GL
+//thread until its time budget is used up, so loading never stalls a frame.
+//Workers also build the mip chain with a box filter and copy it into a mapped
+//pixel buffer when one is free, the upload is then a DMA from the buffer
+//instead of a copy from client memory.
+class TextureLoader{
+private:
+    struct Request{
+        Texture* texture;
+        std::string path;
+    };
+    struct Decoded{
+        Texture* texture;
+        KtxFile* ktx;               //set for .ktx files, uploaded as they are
+        int pixelBuffer;            //PixelBufferPool::None if the pixels are in client memory
+        unsigned char* pixels;      //mip chain, nullptr if decoding failed or the chain is in the buffer
+        int width, height;
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<Texture>> m_Textures;
+    unsigned int m_Pending;         //loaded but not uploaded yet, GL thread only
+    PixelBufferPool m_PixelBuffers;
+
+    std::vector<std::thread> m_Workers;
+    std::mutex m_Mutex;
+    std::condition_variable m_RequestCondition;
+    std::condition_variable m_DecodedCondition;
+    std::deque<Request> m_Requests;
+    std::deque<Decoded> m_Decoded;
+    bool m_Stop;
+
+    Decoded decode(const Request& request);
+    void workerMain();
+
+public:
+    //threadCount 0 uses one thread less than there are cores
+    TextureLoader(unsigned int threadCount=0);
+    ~TextureLoader();
+
+    //must be called on the GL thread, the same path returns the same texture
+    Texture& load(const std::string& path);
+
+    //uploads decoded images until budgetMs is exceeded, at least one per call
+    //returns the number of uploaded textures
+    unsigned int update(double budgetMs=2.0);
+    //decodes and uploads everything, blocking
+    void waitAll();
+
+    inline unsigned int getPendingCount() const {return m_Pending;}
+};
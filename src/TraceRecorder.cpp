@@ -0,0 +1,152 @@
+#include "TraceRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+//The fields are relaxed atomics so a concurrent writeChromeTrace() is no data
+//race, on x86 and ARM they compile to plain loads and stores.
+struct EventSlot{
+    std::atomic<const char*> name;
+    std::atomic<const char*> category;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> duration;
+};
+
+//Written by its thread only. m_Begun is raised before a slot is overwritten
+//and m_Count after, a reader that copied a slot checks m_Begun afterwards to
+//see if the slot was overwritten meanwhile (a seqlock per slot).
+struct ThreadBuffer{
+    EventSlot events[TraceRecorder::EventsPerThread];
+    std::atomic<uint64_t> begun;
+    std::atomic<uint64_t> count;
+    unsigned int id;
+    char name[32];                  //guarded by s_Mutex
+};
+
+std::atomic<bool> TraceRecorder::s_Enabled(false);
+
+static const Clock::time_point s_Epoch = Clock::now();
+
+//rings outlive their threads so a trace written at exit still has their events
+static std::mutex s_Mutex;
+static std::vector<ThreadBuffer*> s_Buffers;
+static thread_local ThreadBuffer* s_Buffer = nullptr;
+//kept until the ring is allocated, threads that never record don't get one
+static thread_local char s_ThreadName[32] = "";
+
+static ThreadBuffer* getBuffer(){
+    if(s_Buffer)
+        return s_Buffer;
+    ThreadBuffer* buffer = new ThreadBuffer();
+    buffer->begun.store(0, std::memory_order_relaxed);
+    buffer->count.store(0, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    buffer->id = s_Buffers.size()+1;
+    if(s_ThreadName[0])
+        snprintf(buffer->name, sizeof(buffer->name), "%s", s_ThreadName);
+    else
+        snprintf(buffer->name, sizeof(buffer->name), "thread %u", buffer->id);
+    s_Buffers.push_back(buffer);
+    s_Buffer = buffer;
+    return buffer;
+}
+
+void TraceRecorder::setEnabled(bool enabled){
+    s_Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::setThreadName(const char* name){
+    snprintf(s_ThreadName, sizeof(s_ThreadName), "%s", name);
+    if(!s_Buffer)
+        return;
+    std::lock_guard<std::mutex> lock(s_Mutex);
+    snprintf(s_Buffer->name, sizeof(s_Buffer->name), "%s", name);
+}
+
+uint64_t TraceRecorder::now(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now()-s_Epoch).count();
+}
+
+void TraceRecorder::record(const char* name, const char* category, uint64_t start, uint64_t end){
+    ThreadBuffer* buffer = getBuffer();
+    uint64_t index = buffer->count.load(std::memory_order_relaxed);
+    buffer->begun.store(index+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    EventSlot& slot = buffer->events[index % EventsPerThread];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(end > start ? end-start : 0, std::memory_order_relaxed);
+    buffer->count.store(index+1, std::memory_order_release);
+}
+
+struct Event{
+    const char* name;
+    const char* category;
+    uint64_t start, duration;
+};
+
+//copies the events of a ring that weren't overwritten during the copy, oldest first
+static void copyEvents(ThreadBuffer& buffer, std::vector<Event>& events){
+    const uint64_t size = TraceRecorder::EventsPerThread;
+    uint64_t count = buffer.count.load(std::memory_order_acquire);
+    uint64_t first = count > size ? count-size : 0;
+
+    events.clear();
+    for(uint64_t i=first; i<count; i++){
+        EventSlot& slot = buffer.events[i % size];
+        Event event;
+        event.name = slot.name.load(std::memory_order_relaxed);
+        event.category = slot.category.load(std::memory_order_relaxed);
+        event.start = slot.start.load(std::memory_order_relaxed);
+        event.duration = slot.duration.load(std::memory_order_relaxed);
+        events.push_back(event);
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t begun = buffer.begun.load(std::memory_order_relaxed);
+    uint64_t valid = begun > size ? begun-size : 0;    //first index that is still intact
+    if(valid > first)
+        events.erase(events.begin(), events.begin()+std::min<uint64_t>(valid-first, events.size()));
+}
+
+bool TraceRecorder::writeChromeTrace(const std::string& path){
+    FILE* file = fopen(path.c_str(), "w");
+    if(!file)
+        return false;
+
+    std::vector<ThreadBuffer*> buffers;
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        buffers = s_Buffers;
+        for(unsigned int i=0; i<buffers.size(); i++)
+            names.push_back(buffers[i]->name);
+    }
+
+    fprintf(file, "{\"traceEvents\":[");
+    const char* separator = "\n";
+    std::vector<Event> events;
+    for(unsigned int i=0; i<buffers.size(); i++){
+        unsigned int tid = buffers[i]->id;
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+            separator, tid, names[i].c_str());
+        separator = ",\n";
+
+        copyEvents(*buffers[i], events);
+        for(unsigned int j=0; j<events.size(); j++){
+            const Event& e = events[j];
+            fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                e.name, e.category, tid, e.start/1000.0, e.duration/1000.0);
+        }
+    }
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+//Timeline of renderer events (shader builds, texture decodes and uploads,
+//buffer creation, frames) from any thread, for finding hitches. Every thread
+//writes into its own fixed ring of EventsPerThread events, allocated and
+//registered on its first event. After that recording takes no lock and
+//allocates nothing, the ring's two counters are the only shared state. The
+//oldest events of a thread are overwritten. Writing the trace can run while
+//other threads record, events overwritten during the copy are skipped.
+//Disabled by default, a disabled TraceScope is one relaxed atomic load.
+class TraceRecorder{
+public:
+    static const unsigned int EventsPerThread = 16384;
+
+private:
+    static std::atomic<bool> s_Enabled;
+
+public:
+    static void setEnabled(bool enabled);
+    static inline bool isEnabled() {return s_Enabled.load(std::memory_order_relaxed);}
+
+    //shown as the track name, cheap: a thread's ring is only allocated on its first event
+    static void setThreadName(const char* name);
+
+    //ns since the process started
+    static uint64_t now();
+    //name and category are not copied, use string literals. Only call it while
+    //enabled (TraceScope does), the first call of a thread allocates its ring.
+    static void record(const char* name, const char* category, uint64_t start, uint64_t end);
+
+    //Chrome trace JSON, one track per thread (chrome://tracing, ui.perfetto.dev)
+    static bool writeChromeTrace(const std::string& path);
+};
+
+//records the time between construction and destruction
+class TraceScope{
+private:
+    const char* m_Name;
+    const char* m_Category;
+    bool m_Active;
+    uint64_t m_Start;
+
+public:
+    TraceScope(const char* name, const char* category)
+        : m_Name(name), m_Category(category), m_Active(TraceRecorder::isEnabled()), m_Start(m_Active ? TraceRecorder::now() : 0) {}
+    ~TraceScope(){
+        if(m_Active)
+            TraceRecorder::record(m_Name, m_Category, m_Start, TraceRecorder::now());
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
@@ -0,0 +1,26 @@
+#include "UniformBuffer.h"
+#include <GL/glew.h>
+#include "GLState.h"
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int binding)
+    : m_RendererID(0), m_Size(size), m_Binding(binding)
+{
+    glGenBuffers(1, &m_RendererID);
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    bind();
+}
+
+UniformBuffer::~UniformBuffer(){
+    glDeleteBuffers(1, &m_RendererID);
+    GLState::bufferDeleted(m_RendererID);
+}
+
+void UniformBuffer::setData(const void* data, unsigned int size, unsigned int offset) const{
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, m_RendererID);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+}
+
+void UniformBuffer::bind() const{
+    GLState::bindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "Std140.h"
+#include "vendor/glm/glm/glm.hpp"
+
+//Binding points shared by all programs. Shader binds uniform blocks with
+//these names automatically after linking.
+enum UniformBinding : unsigned int{
+    CameraBinding = 0,
+    TextureHandlesBinding,
+    UniformBindingCount
+};
+
+//std140 "Camera" block, uploaded once per frame:
+//  layout(std140) uniform Camera { mat4 u_ViewProj; mat4 u_View; mat4 u_Proj; };
+struct CameraBlock{
+    glm::mat4 viewProj;
+    glm::mat4 view;
+    glm::mat4 proj;
+
+    static const unsigned int Size = 3*Std140Layout<glm::mat4>::size;
+
+    //replaces the contents of block with the members in block order
+    void pack(Std140Buffer& block) const{
+        block.clear();
+        block.push(viewProj);
+        block.push(view);
+        block.push(proj);
+    }
+};
+
+class UniformBuffer{
+private:
+    unsigned int m_RendererID;
+    unsigned int m_Size;
+    unsigned int m_Binding;
+
+public:
+    UniformBuffer(unsigned int size, unsigned int binding);
+    ~UniformBuffer();
+
+    void setData(const void* data, unsigned int size, unsigned int offset=0) const;
+    inline void setData(const Std140Buffer& block) const {setData(block.getData(), block.getSize());}
+
+    //attaches the buffer to its binding point
+    void bind() const;
+
+    inline unsigned int getBinding() const {return m_Binding;}
+    inline unsigned int getSize() const {return m_Size;}
+};
@@ -1,31 +1,50 @@
 
 #include "VertexArray.h"
 #include "Render.h"
+#include "GLState.h"
 
-VertexArray::VertexArray(){
+VertexArray::VertexArray()
+    : m_AttribCount(0)
+{
     glGenVertexArrays(1,&m_RendererID);
 }
 
 VertexArray::~VertexArray(){
     glDeleteVertexArrays(1, &m_RendererID);
+    GLState::vertexArrayDeleted(m_RendererID);
 }
 
 void VertexArray::addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout){
     bind();
     vb.bind();
+    addLayout(layout);
+}
+
+//streamed data is drawn with a base vertex, the attributes start at offset 0
+void VertexArray::addBuffer(const StreamingBuffer& sb, const VertexBufferLayout& layout){
+    bind();
+    sb.bind();
+    addLayout(layout);
+}
+
+//sets up the attributes of layout for the currently bound GL_ARRAY_BUFFER
+void VertexArray::addLayout(const VertexBufferLayout& layout){
     const auto& elements = layout.getElements();
     unsigned int offset = 0;
     for (unsigned int i=0; i<elements.size(); i++){
         const auto& element = elements[i];
-        glEnableVertexAttribArray(i);
-        glVertexAttribPointer(i, element.count, element.type,element.normalized, layout.getStride(), (const void*)offset);
+        glEnableVertexAttribArray(m_AttribCount);
+        glVertexAttribPointer(m_AttribCount, element.count, element.type,element.normalized, layout.getStride(), (const void*)offset);
+        if(layout.getDivisor() != 0)
+            glVertexAttribDivisor(m_AttribCount, layout.getDivisor());
         offset+=element.count*VertexBufferElement::getSizeOfType(element.type);
+        m_AttribCount++;
     }
 }
 
 void VertexArray::bind() const {
-    glBindVertexArray(m_RendererID);
+    GLState::bindVertexArray(m_RendererID);
 }
 void VertexArray::unbind() const {
-    glBindVertexArray(0);
+    GLState::bindVertexArray(0);
 }
\ No newline at end of file
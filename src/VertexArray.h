@@ -1,17 +1,24 @@
 #pragma once
 #include "VertexBuffer.h"
+#include "StreamingBuffer.h"
 #include "VertexBufferLayout.h"
 
 class VertexArray{
 private:
     unsigned int m_RendererID;
+    unsigned int m_AttribCount;    //next free attribute location
+
+    void addLayout(const VertexBufferLayout& layout);
 
 public:
     VertexArray();
     ~VertexArray();
 
     void addBuffer(const VertexBuffer& vb, const VertexBufferLayout& layout);
+    void addBuffer(const StreamingBuffer& sb, const VertexBufferLayout& layout);
 
     void bind() const;
     void unbind() const;
+
+    inline unsigned int getRendererID() const {return m_RendererID;}
 };
\ No newline at end of file
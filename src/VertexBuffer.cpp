@@ -1,24 +1,28 @@
 #include "VertexBuffer.h"
 #include <GL/glew.h>
+#include "GLState.h"
+#include "TraceRecorder.h"
 
 VertexBuffer::VertexBuffer(const float *data, unsigned int size)
 {
+    TraceScope trace("VertexBuffer create", "buffer");
     glGenBuffers(1, &m_RendererID);              //generate buffer and safe adress
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID); //select (=bind) bufer
+    GLState::bindBuffer(GL_ARRAY_BUFFER, m_RendererID); //select (=bind) bufer
     glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
 }
 
 VertexBuffer::~VertexBuffer()
 {
     glDeleteBuffers(1, &m_RendererID);
+    GLState::bufferDeleted(m_RendererID);
 }
 
 void VertexBuffer::bind() const
 {
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID); //select (=bind) bufer
+    GLState::bindBuffer(GL_ARRAY_BUFFER, m_RendererID); //select (=bind) bufer
 }
 
 void VertexBuffer::unbind() const
 {
-    glBindBuffer(GL_ARRAY_BUFFER, 0); //select (=bind) bufer
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0); //select (=bind) bufer
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <vector>
 #include <GL/glew.h>
+#include "vendor/glm/glm/glm.hpp"
 
 struct VertexBufferElement{
     unsigned int type;
@@ -21,9 +22,13 @@ class VertexBufferLayout{
 private:
     std::vector<VertexBufferElement> m_Elements;
     unsigned int m_Stride;
+    unsigned int m_Divisor;
 public:
     VertexBufferLayout()
-        : m_Stride(0){};
+        : m_Stride(0), m_Divisor(0){};
+
+    //divisor 0: attributes advance per vertex, n: once every n instances
+    inline void setDivisor(unsigned int divisor) { m_Divisor = divisor; }
 
     template<typename T>
     void push(unsigned int count){
@@ -32,6 +37,7 @@ public:
 
     inline const std::vector<VertexBufferElement> getElements() const& { return m_Elements; }
     inline unsigned int getStride() const {return m_Stride;}
+    inline unsigned int getDivisor() const {return m_Divisor;}
 };
 
 template<> inline
@@ -49,3 +55,9 @@ void VertexBufferLayout::push<unsigned char>(unsigned int count){
     VertexBufferLayout::m_Elements.push_back({GL_UNSIGNED_BYTE, count, GL_TRUE});
     VertexBufferLayout::m_Stride += count*VertexBufferElement::getSizeOfType(GL_UNSIGNED_BYTE);
 }
+template<> inline
+void VertexBufferLayout::push<glm::mat4>(unsigned int count){
+    //a mat4 attribute takes 4 consecutive locations, one per column
+    for(unsigned int i=0; i<count*4; i++)
+        push<float>(4);
+}
@@ -2,55 +2,140 @@
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <memory>
+#include <chrono>
 
 #include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
 #include <GL/glew.h>
 #include <SDL2/SDL.h>
 
-#include "GLDebugMessageCallback.h"
+#include "GLDebug.h"
 #include "Render.h"
+#include "GLState.h"
 #include "IndexBuffer.h"
 #include "VertexBuffer.h"
 #include "VertexArray.h"
 #include "Shader.h"
+#include "ShaderLibrary.h"
+#include "UniformBuffer.h"
 #include "texture.h"
+#include "AssetPack.h"
+#include "ImageCache.h"
+#include "HeadlessContext.h"
+#include "FrameReader.h"
+#include "ImageSequence.h"
+#include "Profiler.h"
+#include "TraceRecorder.h"
 #include "vendor/glm/glm/glm.hpp"
 #include "vendor/glm/glm/gtc/matrix_transform.hpp"
 
+//--headless renders a fixed number of frames into an offscreen framebuffer
+//without a window or vsync, e.g. for CI or machines without a display.
+//--profile writes the CPU and GPU timings of the run as Chrome trace JSON.
+//--trace writes a timeline of loading work and frames from all threads.
+//--image-cache keeps decoded images in .imagecache, a warm start skips decoding.
+struct Options{
+    bool headless;
+    unsigned int frames;
+    int width, height;
+    std::string output;     //empty: frames are read back but not written
+    std::string profile;
+    std::string trace;
+    bool imageCache;
+};
+
+static bool parseOptions(int argc, char *argv[], Options& options){
+    options.headless = false;
+    options.imageCache = false;
+    options.frames = 300;
+    options.width = 1000;
+    options.height = 1000;
+    for(int i=1; i<argc; i++){
+        bool hasValue = i+1 < argc;
+        if(strcmp(argv[i], "--headless") == 0)
+            options.headless = true;
+        else if(strcmp(argv[i], "--image-cache") == 0)
+            options.imageCache = true;
+        else if(strcmp(argv[i], "--frames") == 0 && hasValue)
+            options.frames = strtoul(argv[++i], nullptr, 10);
+        else if(strcmp(argv[i], "--output") == 0 && hasValue)
+            options.output = argv[++i];
+        else if(strcmp(argv[i], "--profile") == 0 && hasValue)
+            options.profile = argv[++i];
+        else if(strcmp(argv[i], "--trace") == 0 && hasValue)
+            options.trace = argv[++i];
+        else if(strcmp(argv[i], "--size") == 0 && hasValue){
+            if(sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 || options.width <= 0 || options.height <= 0)
+                return false;
+        }
+        else
+            return false;
+    }
+    return true;
+}
+
 int main(int argc, char *argv[])
 {
-    // ----- Initialize SDL
-    if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
-    {
-        fprintf(stderr, "SDL could not initialize\n");
+    Options options;
+    if(!parseOptions(argc, argv, options)){
+        fprintf(stderr, "Usage: %s [--profile profile.json] [--trace trace.json] [--image-cache] [--headless [--frames N] [--size WxH] [--output dir]]\n", argv[0]);
         return 1;
     }
-
-    // ----- Create window
-    SDL_Window *window = SDL_CreateWindow("Test App", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1000, 1000, SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN);
-    if (!window)
-    {
-        fprintf(stderr, "Error creating window.\n");
-        return 2;
+    //from the start, so shader builds and texture loads are included
+    TraceRecorder::setThreadName("main");
+    TraceRecorder::setEnabled(!options.trace.empty());
+
+    SDL_Window *window = nullptr;
+    SDL_GLContext glContext = nullptr;
+    std::unique_ptr<HeadlessContext> headlessContext;
+    if(options.headless){
+        // ----- EGL context with an offscreen framebuffer, no SDL at all
+        headlessContext.reset(new HeadlessContext(options.width, options.height));
+        if(!headlessContext->isValid())
+            return 4;
+        std::cout << "OpenGL-Version " << glGetString(GL_VERSION) << std::endl;
+        GLDebug::enable();
     }
+    else{
+        // ----- Initialize SDL
+        if (SDL_Init(SDL_INIT_EVERYTHING) != 0)
+        {
+            fprintf(stderr, "SDL could not initialize\n");
+            return 1;
+        }
 
-    // ----- SDL OpenGL context & settings
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
-    SDL_GLContext glContext = SDL_GL_CreateContext(window);
-    glEnable(GL_DEBUG_OUTPUT);
-    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
-    std::cout << "OpenGL-Version " << glGetString(GL_VERSION) << std::endl; //Display Info about OpenGL-Version
+        // ----- Create window
+        window = SDL_CreateWindow("Test App", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1000, 1000, SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN);
+        if (!window)
+        {
+            fprintf(stderr, "Error creating window.\n");
+            return 2;
+        }
 
-    // ----- SDL v-sync
-    SDL_GL_SetSwapInterval(1);
+        // ----- SDL OpenGL context & settings
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+#ifndef NDEBUG
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
+#endif
+        glContext = SDL_GL_CreateContext(window);
+        std::cout << "OpenGL-Version " << glGetString(GL_VERSION) << std::endl; //Display Info about OpenGL-Version
+
+        // ----- SDL v-sync
+        SDL_GL_SetSwapInterval(1);
+
+        // ----- GLEW
+        if (glewInit() != GLEW_OK)
+        {
+            fprintf(stderr, "Error in GLEW-Initalisation\n");
+            return 3;
+        }
 
-    // ----- GLEW
-    if (glewInit() != GLEW_OK)
-    {
-        fprintf(stderr, "Error in GLEW-Initalisation\n");
-        return 3;
+        // ----- GL debug output, registered once and asynchronous (nothing at all with NDEBUG)
+        GLDebug::enable();
     }
     {
 
@@ -105,8 +190,8 @@ int main(int argc, char *argv[])
         };
 
         // ---- Blending
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::setBlend(true);
+        GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         // ---- create Buffers
         VertexArray va;
@@ -122,10 +207,35 @@ int main(int argc, char *argv[])
         glm::mat4 proj = glm::ortho(0.0f, 1000.0f, 0.0f, 1000.0f, -1.0f, 1.0f); //Orthographic matrix
         glm::mat4 view = glm::translate(glm::mat4(1.0f),glm::vec3(0,0,0));
 
-        //Shaders
-        Shader shader("res/shaders/Basic.shader");
+        glm::vec3 translationA(-200,0,0);
+        glm::vec3 translationB(200,0,0);
+
+        // ---- per-instance model matrices, all copies are drawn with one call
+        std::vector<glm::mat4> models = {
+            glm::translate(glm::mat4(1.0f), translationA),
+            glm::translate(glm::mat4(1.0f), translationB)
+        };
+        VertexBuffer instanceVb(&models[0][0][0], models.size() * sizeof(glm::mat4));
+
+        VertexBufferLayout instanceLayout;
+        instanceLayout.setDivisor(1);
+        instanceLayout.push<glm::mat4>(1);
+        va.addBuffer(instanceVb, instanceLayout);
+
+        //camera data shared by all programs, uploaded once per frame
+        UniformBuffer cameraBuffer(CameraBlock::Size, CameraBinding);
+
+        //assets come from res.pack if it was built with "make pack", loose files otherwise
+        AssetPack::mount("res.pack");
+        ImageCache::setDiskCacheEnabled(options.imageCache);
+
+        //Shaders, all compiles are submitted before the first status query
+        ShaderLibrary shaders;
+        shaders.load("instanced", "res/shaders/Instanced.shader");
+        Shader& shader = shaders.get("instanced");
+        UniformHandle colorUniform = shader.getUniformHandle("u_Color");
         shader.bind();
-        shader.setUniform4f("u_Color", 0.f, 1.f, 0.f, 1.f);
+        shader.setUniform4f(colorUniform, 0.f, 1.f, 0.f, 1.f);
 
         // glClearColor(1.0f,1.0f,1.f,1.f); //Set background-color to white
 
@@ -137,50 +247,88 @@ int main(int argc, char *argv[])
 
         //create renderer
         Renderer renderer;
+        Profiler::setEnabled(!options.profile.empty());
 
-        glm::vec3 translationA(-200,0,0);
-        glm::vec3 translationB(200,0,0);
-
-        // ----- Game loop
-        bool quit = false;
-        SDL_Event windowEvent;
-        while (quit == false)
-        {
-            while (SDL_PollEvent(&windowEvent))
-            {
-                if (windowEvent.type == SDL_QUIT)
-                {
-                    quit = true;
-                    break;
-                }
-            }
-
-            //DRAWING
+        CameraBlock camera = {proj * view, view, proj};
+        Std140Buffer cameraData;
+        camera.pack(cameraData);
+        auto drawFrame = [&](){
             renderer.clear();
-            glDebugMessageCallback(GLDebugMessageCallback, nullptr); //Debugging-function
+
+            cameraBuffer.setData(cameraData);
 
             shader.bind();
-            shader.setUniform4f("u_Color", 0.f, 1.f, 0.f, 1.f);
+            shader.setUniform4f(colorUniform, 0.f, 1.f, 0.f, 1.f);
+            renderer.drawInstanced(va, ib, shader, models.size());
+        };
 
-            {
-                glm::mat4 model = glm::translate(glm::mat4(1.0f), translationA);
-                glm::mat4 mvp = proj * view * model;
-                shader.setUniformMat4f("u_MVP", mvp);
-                renderer.draw(va, ib, shader);
-            }
-            { 
-                glm::mat4 model = glm::translate(glm::mat4(1.0f), translationB);
-                glm::mat4 mvp = proj * view * model;
-                shader.setUniformMat4f("u_MVP", mvp);
-                renderer.draw(va, ib, shader);
+        if(options.headless){
+            // ----- Offscreen loop, frames are read back while the next ones render
+            std::unique_ptr<ImageSequence> sequence;
+            if(!options.output.empty())
+                sequence.reset(new ImageSequence(options.output));
+            int width = options.width, height = options.height;
+            FrameReader reader(width, height, [&](unsigned int frame, const unsigned char* pixels){
+                if(sequence)
+                    sequence->add(frame, width, height, pixels);
+            });
+
+            auto start = std::chrono::steady_clock::now();
+            for(unsigned int frame=0; frame<options.frames; frame++){
+                TraceScope trace("frame", "frame");
+                Profiler::beginFrame();
+                drawFrame();
+                GLDebug::poll();
+                ProfileScope scope("readback");
+                reader.read(frame);
             }
+            reader.finish();
+            if(sequence)
+                sequence->finish();
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now()-start).count();
+
+            printf("%u frames at %dx%d in %.1f ms (%.1f fps)\n", options.frames, width, height, ms, options.frames*1000.0/ms);
+            if(sequence)
+                printf("wrote %u frames to %s, %u failed\n", sequence->getWrittenCount(), options.output.c_str(), sequence->getFailedCount());
+        }
+        else{
+            // ----- Game loop
+            bool quit = false;
+            SDL_Event windowEvent;
+            while (quit == false)
+            {
+                while (SDL_PollEvent(&windowEvent))
+                {
+                    if (windowEvent.type == SDL_QUIT)
+                    {
+                        quit = true;
+                        break;
+                    }
+                }
 
+                //DRAWING
+                TraceScope trace("frame", "frame");
+                Profiler::beginFrame();
+                drawFrame();
+                GLDebug::poll();
 
+                ProfileScope scope("swap");
+                SDL_GL_SwapWindow(window);
+            }
+        }
 
-            SDL_GL_SwapWindow(window);
+        if(Profiler::isEnabled()){
+            Profiler::setEnabled(false);
+            Profiler::printSummary();
+            if(!Profiler::writeChromeTrace(options.profile))
+                fprintf(stderr, "Can't write '%s'\n", options.profile.c_str());
         }
     }
-    SDL_GL_DeleteContext(glContext);
+    if(glContext)
+        SDL_GL_DeleteContext(glContext);
+
+    if(TraceRecorder::isEnabled() && !TraceRecorder::writeChromeTrace(options.trace))
+        fprintf(stderr, "Can't write '%s'\n", options.trace.c_str());
 
     return 0;
 }
\ No newline at end of file
@@ -271,6 +271,12 @@ RECENT REVISION HISTORY:
 // you have issues compiling it, you can disable it entirely by
 // defining STBI_NO_SIMD.
 //
+// Local patch (OpenGL-Demo): the PNG decoder unfilters 8-bit RGB/RGBA rows
+// with the same SSE2/NEON switches as the JPEG decoder, and inflate uses a
+// larger fast huffman table, bulk bit refills and wide match copies. Output
+// is byte for byte the same. Define STBI_NO_FAST_PNG to get the upstream
+// code paths back (bench/PngDecodeBenchmark compares both).
+//
 // ===========================================================================
 //
 // HDR image support   (disable by defining STBI_NO_HDR)
@@ -4024,7 +4030,11 @@ static int stbi__jpeg_info(stbi__context *s, int *x, int *y, int *comp)
 #ifndef STBI_NO_ZLIB
 
 // fast-way is faster to check than jpeg huffman, but slow way is slower
+#ifdef STBI_NO_FAST_PNG
 #define STBI__ZFAST_BITS  9 // accelerate all cases in default tables
+#else
+#define STBI__ZFAST_BITS  10 // also most codes of dynamic tables, symbols still fit the 9 low bits
+#endif
 #define STBI__ZFAST_MASK  ((1 << STBI__ZFAST_BITS) - 1)
 #define STBI__ZNSYMS 288 // number of symbols in literal/length alphabet
 
@@ -4136,6 +4146,20 @@ stbi_inline static stbi_uc stbi__zget8(stbi__zbuf *z)
 
 static void stbi__fill_bits(stbi__zbuf *z)
 {
+#ifndef STBI_NO_FAST_PNG
+   // with 4 bytes left no byte can hit the end, skip the per-byte checks
+   if (z->zbuffer_end - z->zbuffer >= 4) {
+      if (z->code_buffer >= (1U << z->num_bits)) {
+        z->zbuffer = z->zbuffer_end;  /* treat this as EOF so we fail. */
+        return;
+      }
+      do {
+         z->code_buffer |= (unsigned int) *z->zbuffer++ << z->num_bits;
+         z->num_bits += 8;
+      } while (z->num_bits <= 24);
+      return;
+   }
+#endif
    do {
       if (z->code_buffer >= (1U << z->num_bits)) {
         z->zbuffer = z->zbuffer_end;  /* treat this as EOF so we fail. */
@@ -4265,6 +4289,19 @@ static int stbi__parse_huffman_block(stbi__zbuf *a)
          if (dist == 1) { // run of one byte; common in images.
             stbi_uc v = *p;
             if (len) { do *zout++ = v; while (--len); }
+#ifndef STBI_NO_FAST_PNG
+         } else if (dist >= 8 && a->zout_end - zout >= len + 8) {
+            // 8 bytes at a time, the source is always 8 bytes behind so every
+            // chunk reads finished output. Up to 7 bytes past the match are
+            // scratch, later output overwrites them.
+            char *end = zout + len;
+            do {
+               memcpy(zout, p, 8);
+               zout += 8;
+               p += 8;
+            } while (zout < end);
+            zout = end;
+#endif
          } else {
             if (len) { do *zout++ = *p++; while (--len); }
          }
@@ -4583,6 +4620,135 @@ static int stbi__paeth(int a, int b, int c)
 
 static const stbi_uc stbi__depth_scale_table[9] = { 0, 0xff, 0x55, 0, 0x11, 0,0,0, 0x01 };
 
+#if !defined(STBI_NO_FAST_PNG) && (defined(STBI_SSE2) || defined(STBI_NEON))
+#define STBI__PNG_SIMD
+
+// pixels of 3 or 4 bytes as the low lanes of a vector, little endian
+static stbi__uint32 stbi__png_load_pixel(const stbi_uc *p, int n)
+{
+   stbi__uint32 v = 0;
+   memcpy(&v, p, n);
+   return v;
+}
+
+static void stbi__png_store_pixel(stbi_uc *p, stbi__uint32 v, int n)
+{
+   memcpy(p, &v, n);
+}
+
+#ifdef STBI_SSE2
+static __m128i stbi__paeth_sse2(__m128i a8, __m128i b8, __m128i c8)
+{
+   // same as stbi__paeth on 16-bit lanes, ties prefer a, then b
+   __m128i zero = _mm_setzero_si128();
+   __m128i a = _mm_unpacklo_epi8(a8, zero);
+   __m128i b = _mm_unpacklo_epi8(b8, zero);
+   __m128i c = _mm_unpacklo_epi8(c8, zero);
+   __m128i pa = _mm_sub_epi16(b, c); // p-a
+   __m128i pb = _mm_sub_epi16(a, c); // p-b
+   __m128i pc = _mm_add_epi16(pa, pb); // p-c
+   __m128i smallest, use_a, use_b, nearest;
+   pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+   pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+   pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+   smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+   use_b = _mm_cmpeq_epi16(smallest, pb);
+   use_a = _mm_cmpeq_epi16(smallest, pa);
+   nearest = _mm_or_si128(_mm_and_si128(use_b, b), _mm_andnot_si128(use_b, c));
+   nearest = _mm_or_si128(_mm_and_si128(use_a, a), _mm_andnot_si128(use_a, nearest));
+   return _mm_packus_epi16(nearest, nearest);
+}
+#endif
+
+#ifdef STBI_NEON
+static uint8x8_t stbi__paeth_neon(uint8x8_t a, uint8x8_t b, uint8x8_t c)
+{
+   uint16x8_t pa = vabdl_u8(b, c); // |p-a|
+   uint16x8_t pb = vabdl_u8(a, c); // |p-b|
+   uint16x8_t pc = vabdq_u16(vaddl_u8(a, b), vaddl_u8(c, c)); // |p-c|
+   uint8x8_t use_a = vmovn_u16(vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc)));
+   uint8x8_t use_b = vmovn_u16(vcleq_u16(pb, pc));
+   return vbsl_u8(use_a, a, vbsl_u8(use_b, b, c));
+}
+#endif
+
+// Unfilters the rest of an 8-bit row of 3 or 4 byte pixels after the first
+// pixel, count pixels. Sub, avg and paeth depend on the pixel to the left, so
+// they work on one pixel per vector. With img_n 3 and out_n 4 alpha is set
+// to 255. The first row filters stay scalar.
+static void stbi__png_unfilter_row_simd(int filter, stbi_uc *cur, const stbi_uc *prior, const stbi_uc *raw, stbi__uint32 count, int img_n, int out_n)
+{
+   stbi__uint32 i, alpha = (img_n != out_n) ? 0xff000000u : 0;
+
+   if (filter == STBI__F_up && img_n == out_n) {
+      // no dependency inside the row, 16 bytes at a time
+      stbi__uint32 n = count*img_n, k = 0;
+#ifdef STBI_SSE2
+      for (; k+16 <= n; k += 16)
+         _mm_storeu_si128((__m128i *) (cur+k), _mm_add_epi8(_mm_loadu_si128((const __m128i *) (raw+k)), _mm_loadu_si128((const __m128i *) (prior+k))));
+#else
+      for (; k+16 <= n; k += 16)
+         vst1q_u8(cur+k, vaddq_u8(vld1q_u8(raw+k), vld1q_u8(prior+k)));
+#endif
+      for (; k < n; ++k)
+         cur[k] = STBI__BYTECAST(raw[k] + prior[k]);
+      return;
+   }
+
+#ifdef STBI_SSE2
+   {
+      __m128i a = _mm_cvtsi32_si128((int) stbi__png_load_pixel(cur - out_n, out_n));   // left
+      __m128i c = _mm_setzero_si128(); // upper left
+      __m128i one = _mm_set1_epi8(1);
+      #define STBI__LOAD(p, n) _mm_cvtsi32_si128((int) stbi__png_load_pixel(p, n))
+      if (filter == STBI__F_paeth) c = STBI__LOAD(prior - out_n, out_n); // only paeth reads it, the first row has no prior row
+      #define STBI__CASE(f) \
+         case f: \
+            for (i=0; i < count; ++i, stbi__png_store_pixel(cur, (stbi__uint32) _mm_cvtsi128_si32(a) | alpha, out_n), raw+=img_n, cur+=out_n, prior+=out_n)
+      switch (filter) {
+         STBI__CASE(STBI__F_sub)    { a = _mm_add_epi8(STBI__LOAD(raw, img_n), a); } break;
+         STBI__CASE(STBI__F_up)     { a = _mm_add_epi8(STBI__LOAD(raw, img_n), STBI__LOAD(prior, out_n)); } break;
+         STBI__CASE(STBI__F_avg)    {
+            // pavgb rounds up, (a+b)>>1 doesn't
+            __m128i b = STBI__LOAD(prior, out_n);
+            __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+            a = _mm_add_epi8(STBI__LOAD(raw, img_n), avg);
+         } break;
+         STBI__CASE(STBI__F_paeth)  {
+            __m128i b = STBI__LOAD(prior, out_n);
+            a = _mm_add_epi8(STBI__LOAD(raw, img_n), stbi__paeth_sse2(a, b, c));
+            c = b;
+         } break;
+      }
+      #undef STBI__CASE
+      #undef STBI__LOAD
+   }
+#else
+   {
+      uint8x8_t a = vcreate_u8(stbi__png_load_pixel(cur - out_n, out_n));   // left
+      uint8x8_t c = vdup_n_u8(0); // upper left
+      #define STBI__LOAD(p, n) vcreate_u8(stbi__png_load_pixel(p, n))
+      if (filter == STBI__F_paeth) c = STBI__LOAD(prior - out_n, out_n); // only paeth reads it, the first row has no prior row
+      #define STBI__CASE(f) \
+         case f: \
+            for (i=0; i < count; ++i, stbi__png_store_pixel(cur, vget_lane_u32(vreinterpret_u32_u8(a), 0) | alpha, out_n), raw+=img_n, cur+=out_n, prior+=out_n)
+      switch (filter) {
+         STBI__CASE(STBI__F_sub)    { a = vadd_u8(STBI__LOAD(raw, img_n), a); } break;
+         STBI__CASE(STBI__F_up)     { a = vadd_u8(STBI__LOAD(raw, img_n), STBI__LOAD(prior, out_n)); } break;
+         STBI__CASE(STBI__F_avg)    { a = vadd_u8(STBI__LOAD(raw, img_n), vhadd_u8(a, STBI__LOAD(prior, out_n))); } break;
+         STBI__CASE(STBI__F_paeth)  {
+            uint8x8_t b = STBI__LOAD(prior, out_n);
+            a = vadd_u8(STBI__LOAD(raw, img_n), stbi__paeth_neon(a, b, c));
+            c = b;
+         } break;
+      }
+      #undef STBI__CASE
+      #undef STBI__LOAD
+   }
+#endif
+}
+#endif // STBI__PNG_SIMD
+
 // create the png data from post-deflated data
 static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 raw_len, int out_n, stbi__uint32 x, stbi__uint32 y, int depth, int color)
 {
@@ -4668,6 +4834,11 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
          #define STBI__CASE(f) \
              case f:     \
                 for (k=0; k < nk; ++k)
+#ifdef STBI__PNG_SIMD
+         if (depth == 8 && filter_bytes >= 3 && filter >= STBI__F_sub && filter <= STBI__F_paeth)
+            stbi__png_unfilter_row_simd(filter, cur, prior, raw, width-1, img_n, out_n);
+         else
+#endif
          switch (filter) {
             // "none" filter turns into a memcpy here; make that explicit.
             case STBI__F_none:         memcpy(cur, raw, nk); break;
@@ -4686,6 +4857,12 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
              case f:     \
                 for (i=x-1; i >= 1; --i, cur[filter_bytes]=255,raw+=filter_bytes,cur+=output_bytes,prior+=output_bytes) \
                    for (k=0; k < filter_bytes; ++k)
+#ifdef STBI__PNG_SIMD
+         if (depth == 8 && img_n == 3 && filter >= STBI__F_sub && filter <= STBI__F_paeth) {
+            stbi__png_unfilter_row_simd(filter, cur, prior, raw, x-1, img_n, out_n);
+            raw += (x-1)*img_n;
+         } else
+#endif
          switch (filter) {
             STBI__CASE(STBI__F_none)         { cur[k] = raw[k]; } break;
             STBI__CASE(STBI__F_sub)          { cur[k] = STBI__BYTECAST(raw[k] + cur[k- output_bytes]); } break;
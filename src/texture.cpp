@@ -1,36 +1,167 @@
 #include "texture.h"
 
-#include "stb_image.h"
+#include "GLState.h"
+#include "KtxFile.h"
+#include "Mipmap.h"
+#include "ImageCache.h"
+#include "TraceRecorder.h"
 
-Texture::Texture(const std::string& path)
-    : m_RendererID(0), m_FilePath(path), m_LocalBuffer(nullptr), m_Width(0), m_Height(0), m_BPP(0)
-{
-    stbi_set_flip_vertically_on_load(1);
-    m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
-    
+#include <algorithm>
+#include <iostream>
+
+void Texture::create(){
     glGenTextures(1, &m_RendererID);
-    glBindTexture(GL_TEXTURE_2D, m_RendererID);
+    GLState::bindTexture(0, GL_TEXTURE_2D, m_RendererID);
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+};
+
+Texture::Texture(const std::string& path)
+    : m_RendererID(0), m_FilePath(path), m_Width(0), m_Height(0), m_BPP(0), m_LevelCount(1), m_BindlessHandle(0)
+{
+    create();
+
+    //pre-compressed, already flipped by the converter
+    if(KtxFile::isKtxPath(path)){
+        KtxFile file;
+        {
+            TraceScope trace("Texture decode", "texture");
+            if(!file.load(path))
+                return;
+        }
+        TraceScope trace("Texture upload", "texture");
+        setData(file);
+        return;
+    }
+
+    std::shared_ptr<const DecodedImage> image;
+    {
+        TraceScope trace("Texture decode", "texture");
+        image = ImageCache::load(path);
+    }
+    if(!image){
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        setLevelCount(1);
+        return;
+    }
+
+    m_Width = image->width;
+    m_Height = image->height;
+    m_BPP = image->bpp;
+    TraceScope trace("Texture upload", "texture");
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image->pixels);
+    generateMipmaps();
+};
+
+Texture::Texture(int width, int height, const unsigned char* pixels)
+    : m_RendererID(0), m_Width(width), m_Height(height), m_BPP(4), m_LevelCount(1), m_BindlessHandle(0)
+{
+    TraceScope trace("Texture upload", "texture");
+    create();
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    setLevelCount(1);
+};
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer);
+//the max level matches the allocated levels so the texture stays complete, mip filtering needs a chain
+void Texture::setLevelCount(int levelCount){
+    m_LevelCount = levelCount;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount-1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+};
+
+//the storage of a texture with a handle is immutable, start over with a new texture
+void Texture::releaseHandle(){
+    if(!m_BindlessHandle)
+        return;
+    glMakeTextureHandleNonResidentARB(m_BindlessHandle);
+    m_BindlessHandle = 0;
+    glDeleteTextures(1, &m_RendererID);
+    GLState::textureDeleted(m_RendererID);
+    create();
+};
+
+uint64_t Texture::getBindlessHandle() const{
+    if(!m_BindlessHandle && GLEW_ARB_bindless_texture){
+        m_BindlessHandle = glGetTextureHandleARB(m_RendererID);
+        glMakeTextureHandleResidentARB(m_BindlessHandle);
+    }
+    return m_BindlessHandle;
+};
+
+void Texture::setData(int width, int height, const unsigned char* pixels){
+    releaseHandle();
+    m_Width = width;
+    m_Height = height;
+    GLState::bindTexture(0, GL_TEXTURE_2D, m_RendererID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    setLevelCount(1);
+};
+
+void Texture::setData(const KtxFile& file){
+    if(!KtxFile::isFormatSupported(file.getInternalFormat())){
+        std::cout << "Texture format 0x" << std::hex << file.getInternalFormat() << std::dec << " is not supported" << std::endl;
+        return;
+    }
+    releaseHandle();
+
+    m_Width = file.getWidth();
+    m_Height = file.getHeight();
+    GLState::bindTexture(0, GL_TEXTURE_2D, m_RendererID);
+
+    const std::vector<KtxFile::Level>& levels = file.getLevels();
+    for(unsigned int i=0; i<levels.size(); i++){
+        const KtxFile::Level& level = levels[i];
+        if(file.isCompressed())
+            glCompressedTexImage2D(GL_TEXTURE_2D, i, file.getInternalFormat(), level.width, level.height, 0, level.size, level.data);
+        else
+            glTexImage2D(GL_TEXTURE_2D, i, file.getInternalFormat(), level.width, level.height, 0, file.getFormat(), file.getType(), level.data);
+    }
+    setLevelCount(levels.size());
+};
+
+void Texture::resize(int width, int height, int levelCount){
+    releaseHandle();
+    m_Width = width;
+    m_Height = height;
+    GLState::bindTexture(0, GL_TEXTURE_2D, m_RendererID);
+    for(int level=0; level<levelCount; level++){
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        width = std::max(width/2, 1);
+        height = std::max(height/2, 1);
+    }
+    setLevelCount(levelCount);
+};
+
+void Texture::setSubData(int x, int y, int width, int height, const void* pixels, int level){
+    GLState::bindTexture(0, GL_TEXTURE_2D, m_RendererID);
+    glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+};
 
-    if(m_LocalBuffer)
-        stbi_image_free(m_LocalBuffer);
+void Texture::generateMipmaps(){
+    if(m_BindlessHandle){
+        std::cout << "Warning: Mipmaps of a resident texture can't be generated" << std::endl;
+        return;
+    }
+    GLState::bindTexture(0, GL_TEXTURE_2D, m_RendererID);
+    setLevelCount(getMipLevelCount(m_Width, m_Height));
+    glGenerateMipmap(GL_TEXTURE_2D);
 };
 
 Texture::~Texture(){
+    if(m_BindlessHandle)
+        glMakeTextureHandleNonResidentARB(m_BindlessHandle);
     glDeleteTextures(1,&m_RendererID);
+    GLState::textureDeleted(m_RendererID);
 };
 
 void Texture::bind(unsigned int slot) const{
-    glActiveTexture(GL_TEXTURE0+slot);
-    glBindTexture(GL_TEXTURE_2D, m_RendererID);
+    GLState::bindTexture(slot, GL_TEXTURE_2D, m_RendererID);
 };
 
-void Texture::unbind() const{
-    glBindTexture(GL_TEXTURE_2D, 0);
+void Texture::unbind(unsigned int slot) const{
+    GLState::bindTexture(slot, GL_TEXTURE_2D, 0);
 };
\ No newline at end of file
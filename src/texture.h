@@ -1,22 +1,48 @@
 #pragma once
+#include <stdint.h>
 
 #include "Render.h"
 
+class KtxFile;
+
 class Texture{
 private:
     unsigned int m_RendererID;
     std::string m_FilePath;
-    unsigned char* m_LocalBuffer;
     int m_Width, m_Height;
     int m_BPP; //BPP = bits per pixel
+    int m_LevelCount;
+    mutable uint64_t m_BindlessHandle;
+
+    void create();
+    void setLevelCount(int levelCount);
+    void releaseHandle();
 
 public:
-    Texture(const std::string& path);
+    Texture(const std::string& path);   //.ktx files are uploaded as they are, anything else is decoded to RGBA8 with mipmaps through the ImageCache
+    Texture(int width, int height, const unsigned char* pixels);   //RGBA8 pixels from memory
     ~Texture();
 
+    //replaces the image without mip levels, the GL name stays the same
+    void setData(int width, int height, const unsigned char* pixels);
+    //replaces the image with all levels of a KTX file, compressed data is uploaded without decoding
+    void setData(const KtxFile& file);
+    //reallocates levelCount levels without initializing them
+    void resize(int width, int height, int levelCount=1);
+    //RGBA8 pixels, an offset into the buffer if a GL_PIXEL_UNPACK_BUFFER is bound
+    void setSubData(int x, int y, int width, int height, const void* pixels, int level=0);
+    //builds all levels from the first one on the GPU, call it before taking a bindless handle
+    void generateMipmaps();
+
+    //ARB_bindless_texture handle, made resident on first use. A resident texture
+    //can't be respecified, setData() and resize() create a new GL texture.
+    uint64_t getBindlessHandle() const;
+
     void bind(unsigned int slot=0) const;
-    void unbind() const;
+    void unbind(unsigned int slot=0) const;
 
     inline int getWidth() const {return m_Width;}
     inline int getHeight() const {return m_Height;}
+    inline int getLevelCount() const {return m_LevelCount;}
+    inline unsigned int getRendererID() const {return m_RendererID;}
 };
\ No newline at end of file
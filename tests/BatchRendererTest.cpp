@@ -0,0 +1,130 @@
+// Checks that quads which start a new batch sample the texture they were drawn
+// with. Runs headless, e.g. on llvmpipe:
+//   LIBGL_ALWAYS_SOFTWARE=1 ./BatchRendererTest
+#include <stdio.h>
+#include <GL/glew.h>
+
+#include "HeadlessContext.h"
+#include "BatchRenderer.h"
+#include "Render.h"
+#include "UniformBuffer.h"
+#include "vendor/glm/glm/glm.hpp"
+#include "vendor/glm/glm/gtc/matrix_transform.hpp"
+
+static const int MaxQuads = 2;
+static const int QuadCount = MaxQuads*2+1;
+static const int QuadSize = 16;
+
+static const unsigned char Colors[QuadCount][4] = {
+    {255, 0, 0, 255}, {0, 255, 0, 255}, {0, 0, 255, 255}, {255, 255, 0, 255}, {0, 255, 255, 255}
+};
+
+static int s_Failures = 0;
+
+static void check(bool condition, const char* test, const char* message){
+    if(!condition){
+        printf("FAIL %s: %s\n", test, message);
+        s_Failures++;
+    }
+}
+
+//color of the center of the index-th quad
+static void readQuad(int index, unsigned char pixel[4]){
+    glReadPixels(index*QuadSize+QuadSize/2, QuadSize/2, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+}
+
+static bool matches(const unsigned char a[4], const unsigned char b[4]){
+    for(int i=0; i<4; i++){
+        if(a[i] != b[i])
+            return false;
+    }
+    return true;
+}
+
+//the first batch reuses one texture, so the quad that starts the second batch
+//would get a slot the second batch gives to the next texture
+static const int QuadTextures[QuadCount] = {0, 0, 1, 2, 3};
+
+static void testTexturesAcrossFullBatch(bool bindless){
+    const char* name = bindless ? "bindless textures" : "textures";
+    BatchRenderer batch(MaxQuads, bindless);
+    if(batch.isBindless() != bindless){
+        printf("SKIP %s: needs ARB_bindless_texture and NV_gpu_shader5\n", name);
+        return;
+    }
+    Texture* textures[QuadCount];
+    for(int i=0; i<QuadCount; i++)
+        textures[i] = new Texture(1, 1, Colors[i]);
+
+    Renderer renderer;
+    renderer.clear();
+    batch.beginScene();
+    for(int i=0; i<QuadCount; i++)
+        batch.drawQuad(glm::vec2(i*QuadSize, 0.0f), glm::vec2(QuadSize), *textures[QuadTextures[i]]);
+    batch.endScene();
+
+    check(batch.getStats().drawCalls == (QuadCount+MaxQuads-1)/MaxQuads, name, "unexpected number of draw calls");
+    for(int i=0; i<QuadCount; i++){
+        const unsigned char* expected = Colors[QuadTextures[i]];
+        unsigned char pixel[4];
+        readQuad(i, pixel);
+        if(!matches(pixel, expected)){
+            printf("FAIL %s: quad %d is %d,%d,%d,%d instead of %d,%d,%d,%d\n", name, i,
+                pixel[0], pixel[1], pixel[2], pixel[3], expected[0], expected[1], expected[2], expected[3]);
+            s_Failures++;
+        }
+    }
+    for(int i=0; i<QuadCount; i++)
+        delete textures[i];
+}
+
+//a full batch of colored quads, then a layer of one array and a layer of another
+static void testArrayAfterFullBatch(){
+    const char* name = "texture array";
+    TextureArray first(1, 1, 2), second(1, 1, 2);
+    first.setLayer(0, Colors[0]);
+    first.setLayer(1, Colors[1]);
+    second.setLayer(0, Colors[2]);
+    second.setLayer(1, Colors[3]);
+
+    BatchRenderer batch(MaxQuads, false);
+    Renderer renderer;
+    renderer.clear();
+    batch.beginScene();
+    for(int i=0; i<MaxQuads; i++)
+        batch.drawQuad(glm::vec2(i*QuadSize, 0.0f), glm::vec2(QuadSize), glm::vec4(1.0f));
+    batch.drawQuad(glm::vec2(MaxQuads*QuadSize, 0.0f), glm::vec2(QuadSize), first, 1);
+    batch.drawQuad(glm::vec2((MaxQuads+1)*QuadSize, 0.0f), glm::vec2(QuadSize), second, 0);
+    batch.endScene();
+
+    unsigned char pixel[4];
+    readQuad(MaxQuads, pixel);
+    check(matches(pixel, Colors[1]), name, "the layer drawn after a flush isn't sampled from its array");
+    readQuad(MaxQuads+1, pixel);
+    check(matches(pixel, Colors[2]), name, "the layer of the second array isn't sampled from it");
+}
+
+int main()
+{
+    HeadlessContext context(QuadCount*QuadSize, QuadSize);
+    if(!context.isValid())
+        return 1;
+
+    glm::mat4 proj = glm::ortho(0.0f, (float)(QuadCount*QuadSize), 0.0f, (float)QuadSize, -1.0f, 1.0f);
+    CameraBlock camera = {proj, glm::mat4(1.0f), proj};
+    Std140Buffer cameraData;
+    camera.pack(cameraData);
+    UniformBuffer cameraBuffer(CameraBlock::Size, CameraBinding);
+    cameraBuffer.setData(cameraData);
+
+    testTexturesAcrossFullBatch(false);
+    testTexturesAcrossFullBatch(true);
+    testArrayAfterFullBatch();
+
+    if(s_Failures){
+        printf("%d checks failed\n", s_Failures);
+        return 1;
+    }
+    printf("BatchRendererTest passed\n");
+    return 0;
+}
@@ -0,0 +1,160 @@
+//Packs files and directories into one asset pack that AssetPack::mount()
+//serves to Shader, Texture and the other loaders instead of loose files.
+//Entries are named by their path as given, e.g. res/shaders/Basic.shader.
+//With --lz4 an entry is stored compressed if that saves at least 1/8 of it,
+//already compressed formats like PNG usually stay uncompressed.
+//
+//    AssetPacker [--lz4] [--align bytes] output.pack inputs...
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "AssetPack.h"
+#include "Lz4.h"
+
+struct Input{
+    std::string name;
+    uint64_t hash;
+};
+
+static void collect(const std::string& path, std::vector<Input>& inputs){
+    struct stat info;
+    if(stat(path.c_str(), &info) != 0){
+        printf("Can't find '%s'\n", path.c_str());
+        return;
+    }
+    if(!S_ISDIR(info.st_mode)){
+        std::string name = AssetPack::normalizeName(path);
+        inputs.push_back({name, AssetPack::hashName(name)});
+        return;
+    }
+
+    DIR* dir = opendir(path.c_str());
+    if(!dir)
+        return;
+    std::vector<std::string> children;
+    while(dirent* child = readdir(dir)){
+        if(strcmp(child->d_name, ".") != 0 && strcmp(child->d_name, "..") != 0)
+            children.push_back(child->d_name);
+    }
+    closedir(dir);
+
+    //stable output for the same inputs
+    std::sort(children.begin(), children.end());
+    for(unsigned int i=0; i<children.size(); i++)
+        collect(path + "/" + children[i], inputs);
+}
+
+static void pad(std::vector<uint8_t>& out, uint64_t alignment){
+    out.resize((out.size() + alignment-1) / alignment * alignment, 0);
+}
+
+int main(int argc, char** argv){
+    bool compress = false;
+    uint64_t alignment = 16;
+    int arg = 1;
+    for(; arg < argc && argv[arg][0] == '-'; arg++){
+        if(strcmp(argv[arg], "--lz4") == 0)
+            compress = true;
+        else if(strcmp(argv[arg], "--align") == 0 && arg+1 < argc)
+            alignment = strtoul(argv[++arg], nullptr, 10);
+        else
+            break;
+    }
+    //the index is read in place, it needs at least its own alignment
+    if(alignment < alignof(PackEntry) || (alignment & (alignment-1)) != 0){
+        printf("alignment must be a power of two of at least %u\n", (unsigned int)alignof(PackEntry));
+        return 1;
+    }
+    if(argc-arg < 2){
+        printf("usage: %s [--lz4] [--align bytes] output.pack inputs...\n", argv[0]);
+        return 1;
+    }
+    const char* output = argv[arg++];
+
+    std::vector<Input> inputs;
+    for(; arg < argc; arg++)
+        collect(argv[arg], inputs);
+    std::sort(inputs.begin(), inputs.end(), [](const Input& a, const Input& b){
+        return a.hash < b.hash || (a.hash == b.hash && a.name < b.name);
+    });
+    inputs.erase(std::unique(inputs.begin(), inputs.end(), [](const Input& a, const Input& b){
+        return a.name == b.name;
+    }), inputs.end());
+
+    std::vector<uint8_t> out(sizeof(PackHeader), 0);
+    std::vector<PackEntry> entries;
+    std::string names;
+    uint64_t totalSize = 0;
+    for(unsigned int i=0; i<inputs.size(); i++){
+        MappedFile file;
+        if(!file.open(inputs[i].name)){
+            //empty files can't be mapped but are valid entries, anything else would shadow the loose file
+            struct stat info;
+            if(stat(inputs[i].name.c_str(), &info) != 0 || !S_ISREG(info.st_mode) || info.st_size != 0){
+                printf("Can't read '%s'\n", inputs[i].name.c_str());
+                return 1;
+            }
+        }
+
+        PackEntry entry = {};
+        entry.nameHash = inputs[i].hash;
+        entry.size = file.getSize();
+        entry.compression = AssetPack::None;
+        entry.nameOffset = names.size();
+        entry.nameLength = inputs[i].name.size();
+        names += inputs[i].name;
+
+        //every entry starts aligned so it can be used in place, e.g. KTX levels
+        pad(out, alignment);
+        entry.offset = out.size();
+        const uint8_t* data = file.getData();
+        uint64_t storedSize = entry.size;
+        std::vector<uint8_t> compressed;
+        if(compress && entry.size > 0){
+            compressed.resize(lz4CompressBound(entry.size));
+            uint64_t compressedSize = lz4Compress(data, entry.size, &compressed[0]);
+            if(compressedSize < entry.size - entry.size/8){
+                entry.compression = AssetPack::LZ4;
+                data = &compressed[0];
+                storedSize = compressedSize;
+            }
+        }
+        entry.storedSize = storedSize;
+        out.insert(out.end(), data, data+storedSize);
+        entries.push_back(entry);
+        totalSize += entry.size;
+    }
+
+    pad(out, alignment);
+    PackHeader header = {};
+    memcpy(header.magic, PackMagic, sizeof(PackMagic));
+    header.version = PackVersion;
+    header.entryCount = entries.size();
+    header.alignment = alignment;
+    header.indexOffset = out.size();
+    if(!entries.empty())
+        out.insert(out.end(), (const uint8_t*)&entries[0], (const uint8_t*)(&entries[0] + entries.size()));
+    header.namesOffset = out.size();
+    out.insert(out.end(), names.begin(), names.end());
+    memcpy(&out[0], &header, sizeof(header));
+
+    FILE* file = fopen(output, "wb");
+    if(!file || fwrite(&out[0], 1, out.size(), file) != out.size()){
+        printf("Failed to write '%s'\n", output);
+        if(file)
+            fclose(file);
+        return 1;
+    }
+    fclose(file);
+
+    printf("%s: %u files, %llu -> %llu bytes\n", output, (unsigned int)entries.size(),
+        (unsigned long long)totalSize, (unsigned long long)out.size());
+    return 0;
+}
@@ -0,0 +1,268 @@
+//Converts images to BC1 (opaque) or BC3 (with alpha) KTX files with a full
+//mip chain that Texture uploads without decoding. Images are flipped like
+//Texture flips PNGs.
+//
+//    TextureCompressor [--bc1|--bc3] input.png output.ktx
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "stb_image.h"
+#include "KtxFile.h"
+#include "Mipmap.h"
+#include "AssetPack.h"
+
+//GL enums, the tool doesn't link against GL
+static const uint32_t GL_RGB_ = 0x1907;
+static const uint32_t GL_RGBA_ = 0x1908;
+static const uint32_t GL_COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+static const uint32_t GL_COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;
+
+enum class Format{ Auto, BC1, BC3 };
+
+struct Color{
+    float r, g, b;
+};
+
+static uint16_t packColor565(const Color& c){
+    int r = (int)(c.r*31.0f/255.0f+0.5f);
+    int g = (int)(c.g*63.0f/255.0f+0.5f);
+    int b = (int)(c.b*31.0f/255.0f+0.5f);
+    r = r < 0 ? 0 : (r > 31 ? 31 : r);
+    g = g < 0 ? 0 : (g > 63 ? 63 : g);
+    b = b < 0 ? 0 : (b > 31 ? 31 : b);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static Color unpackColor565(uint16_t c){
+    int r = (c >> 11) & 31;
+    int g = (c >> 5) & 63;
+    int b = c & 31;
+    return {(float)((r << 3) | (r >> 2)), (float)((g << 2) | (g >> 4)), (float)((b << 3) | (b >> 2))};
+}
+
+static float distance2(const Color& a, const Color& b){
+    float r = a.r-b.r, g = a.g-b.g, bl = a.b-b.b;
+    return r*r + g*g + bl*bl;
+}
+
+//endpoints along the principal axis of the block's colors, 4 color mode
+static void encodeColorBlock(const uint8_t block[16][4], uint8_t* out){
+    Color colors[16];
+    Color mean = {0.0f, 0.0f, 0.0f};
+    for(int i=0; i<16; i++){
+        colors[i] = {(float)block[i][0], (float)block[i][1], (float)block[i][2]};
+        mean.r += colors[i].r/16.0f;
+        mean.g += colors[i].g/16.0f;
+        mean.b += colors[i].b/16.0f;
+    }
+
+    float cov[6] = {};
+    for(int i=0; i<16; i++){
+        float r = colors[i].r-mean.r, g = colors[i].g-mean.g, b = colors[i].b-mean.b;
+        cov[0] += r*r; cov[1] += r*g; cov[2] += r*b;
+        cov[3] += g*g; cov[4] += g*b; cov[5] += b*b;
+    }
+
+    //power iteration for the dominant eigenvector
+    Color axis = {1.0f, 1.0f, 1.0f};
+    for(int iteration=0; iteration<8; iteration++){
+        Color next = {
+            cov[0]*axis.r + cov[1]*axis.g + cov[2]*axis.b,
+            cov[1]*axis.r + cov[3]*axis.g + cov[4]*axis.b,
+            cov[2]*axis.r + cov[4]*axis.g + cov[5]*axis.b};
+        float length = std::sqrt(next.r*next.r + next.g*next.g + next.b*next.b);
+        if(length < 1e-6f)
+            break;
+        axis = {next.r/length, next.g/length, next.b/length};
+    }
+
+    float minProjection = 1e30f, maxProjection = -1e30f;
+    for(int i=0; i<16; i++){
+        float projection = (colors[i].r-mean.r)*axis.r + (colors[i].g-mean.g)*axis.g + (colors[i].b-mean.b)*axis.b;
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+    //inset the endpoints a little, the interpolated colors cover the extremes better
+    float inset = (maxProjection-minProjection)/16.0f;
+    minProjection += inset;
+    maxProjection -= inset;
+
+    Color high = {mean.r+axis.r*maxProjection, mean.g+axis.g*maxProjection, mean.b+axis.b*maxProjection};
+    Color low = {mean.r+axis.r*minProjection, mean.g+axis.g*minProjection, mean.b+axis.b*minProjection};
+    uint16_t c0 = packColor565(high);
+    uint16_t c1 = packColor565(low);
+    if(c0 < c1)
+        std::swap(c0, c1);
+
+    uint32_t indices = 0;
+    if(c0 != c1){
+        Color palette[4];
+        palette[0] = unpackColor565(c0);
+        palette[1] = unpackColor565(c1);
+        palette[2] = {(2*palette[0].r+palette[1].r)/3, (2*palette[0].g+palette[1].g)/3, (2*palette[0].b+palette[1].b)/3};
+        palette[3] = {(palette[0].r+2*palette[1].r)/3, (palette[0].g+2*palette[1].g)/3, (palette[0].b+2*palette[1].b)/3};
+        for(int i=0; i<16; i++){
+            int best = 0;
+            float bestDistance = distance2(colors[i], palette[0]);
+            for(int p=1; p<4; p++){
+                float d = distance2(colors[i], palette[p]);
+                if(d < bestDistance){
+                    bestDistance = d;
+                    best = p;
+                }
+            }
+            indices |= (uint32_t)best << (i*2);
+        }
+    }
+
+    memcpy(out, &c0, 2);
+    memcpy(out+2, &c1, 2);
+    memcpy(out+4, &indices, 4);
+}
+
+//min and max alpha as endpoints, 8 value mode
+static void encodeAlphaBlock(const uint8_t block[16][4], uint8_t* out){
+    int a0 = 0, a1 = 255;
+    for(int i=0; i<16; i++){
+        a0 = std::max(a0, (int)block[i][3]);
+        a1 = std::min(a1, (int)block[i][3]);
+    }
+
+    uint64_t indices = 0;
+    if(a0 != a1){
+        int palette[8] = {a0, a1};
+        for(int p=1; p<7; p++)
+            palette[p+1] = ((7-p)*a0 + p*a1)/7;
+        for(int i=0; i<16; i++){
+            int best = 0;
+            int bestDistance = 256;
+            for(int p=0; p<8; p++){
+                int d = std::abs(block[i][3]-palette[p]);
+                if(d < bestDistance){
+                    bestDistance = d;
+                    best = p;
+                }
+            }
+            indices |= (uint64_t)best << (i*3);
+        }
+    }
+
+    out[0] = (uint8_t)a0;
+    out[1] = (uint8_t)a1;
+    for(int i=0; i<6; i++)
+        out[2+i] = (uint8_t)(indices >> (i*8));
+}
+
+static std::vector<uint8_t> compress(const uint8_t* pixels, int width, int height, bool alpha){
+    const int blockSize = alpha ? 16 : 8;
+    const int blocksX = (width+3)/4, blocksY = (height+3)/4;
+    std::vector<uint8_t> data(blocksX*blocksY*blockSize);
+
+    uint8_t* out = &data[0];
+    for(int by=0; by<blocksY; by++){
+        for(int bx=0; bx<blocksX; bx++){
+            //edge blocks repeat the last row and column
+            uint8_t block[16][4];
+            for(int y=0; y<4; y++){
+                for(int x=0; x<4; x++){
+                    int px = std::min(bx*4+x, width-1);
+                    int py = std::min(by*4+y, height-1);
+                    memcpy(block[y*4+x], pixels + (py*width+px)*4, 4);
+                }
+            }
+            if(alpha){
+                encodeAlphaBlock(block, out);
+                out += 8;
+            }
+            encodeColorBlock(block, out);
+            out += 8;
+        }
+    }
+    return data;
+}
+
+static bool writeKtx(const std::string& path, int width, int height, bool alpha, const std::vector<std::vector<uint8_t>>& levels){
+    KtxHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.identifier, KtxIdentifier, sizeof(KtxIdentifier));
+    header.endianness = KtxEndianness;
+    header.glTypeSize = 1;
+    header.glInternalFormat = alpha ? GL_COMPRESSED_RGBA_S3TC_DXT5 : GL_COMPRESSED_RGB_S3TC_DXT1;
+    header.glBaseInternalFormat = alpha ? GL_RGBA_ : GL_RGB_;
+    header.pixelWidth = width;
+    header.pixelHeight = height;
+    header.numberOfFaces = 1;
+    header.numberOfMipmapLevels = levels.size();
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if(!file)
+        return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    //block sizes are multiples of 4, no mip padding needed
+    for(unsigned int i=0; i<levels.size() && ok; i++){
+        uint32_t imageSize = levels[i].size();
+        ok = fwrite(&imageSize, sizeof(imageSize), 1, file) == 1
+            && fwrite(&levels[i][0], imageSize, 1, file) == 1;
+    }
+    return fclose(file) == 0 && ok;
+}
+
+int main(int argc, char** argv){
+    Format format = Format::Auto;
+    int arg = 1;
+    if(arg < argc && strcmp(argv[arg], "--bc1") == 0){
+        format = Format::BC1;
+        arg++;
+    }
+    else if(arg < argc && strcmp(argv[arg], "--bc3") == 0){
+        format = Format::BC3;
+        arg++;
+    }
+    if(argc-arg != 2){
+        printf("usage: %s [--bc1|--bc3] input output.ktx\n", argv[0]);
+        return 1;
+    }
+    const char* input = argv[arg];
+    const char* output = argv[arg+1];
+
+    int width = 0, height = 0, bpp = 0;
+    unsigned char* pixels = loadImage(input, width, height, bpp);
+    if(!pixels){
+        printf("Failed to load '%s': %s\n", input, stbi_failure_reason());
+        return 1;
+    }
+
+    bool alpha = format == Format::BC3;
+    if(format == Format::Auto){
+        for(int i=0; i<width*height && !alpha; i++)
+            alpha = pixels[i*4+3] != 255;
+    }
+
+    std::vector<MipLevel> mipLevels = getMipLevels(width, height);
+    std::vector<uint8_t> chain(mipLevels.back().offset + mipLevels.back().size);
+    memcpy(&chain[0], pixels, mipLevels[0].size);
+    stbi_image_free(pixels);
+    generateMipChain(&chain[0], mipLevels);
+
+    std::vector<std::vector<uint8_t>> levels;
+    unsigned int compressedSize = 0;
+    for(unsigned int i=0; i<mipLevels.size(); i++){
+        const MipLevel& level = mipLevels[i];
+        levels.push_back(compress(&chain[level.offset], level.width, level.height, alpha));
+        compressedSize += levels.back().size();
+    }
+
+    if(!writeKtx(output, width, height, alpha, levels)){
+        printf("Failed to write '%s'\n", output);
+        return 1;
+    }
+    printf("%s: %dx%d, %d levels, RGBA8 %d KB -> %s %d KB\n", output, width, height, (int)levels.size(),
+        (int)chain.size()/1024, alpha ? "BC3" : "BC1", compressedSize/1024);
+    return 0;
+}